@@ -0,0 +1,305 @@
+#include "AnalogKeys.h"
+
+#include <util/atomic.h>
+
+#include "mcc_generated_files/system/system.h"
+
+typedef enum {
+    ANALOG_KEY_UP = 0, ANALOG_KEY_PRESSED, ANALOG_KEY_RAPID_RELEASED
+} ANALOG_KEY_STATE;
+
+//Per-key travel state
+typedef struct {
+    ANALOG_KEY_STATE state;
+    
+    //Deepest travel while pressed, or shallowest while rapid released
+    uint16_t turn;
+    
+    //Actuation point
+    uint16_t actuation;
+    
+    //Scans since the key left the reset point
+    uint8_t scans;
+} ANALOG_KEY_t;
+
+//ADC channel of each key
+static const adc_0_channel_t channels[ANALOG_KEYS_COUNT] = ANALOG_KEYS_CHANNELS;
+
+//ADC reading at rest
+static uint16_t restPosition[ANALOG_KEYS_COUNT];
+
+//Travel from the last scan
+static volatile uint16_t travel[ANALOG_KEYS_COUNT];
+
+static ANALOG_KEY_t keys[ANALOG_KEYS_COUNT];
+
+//Statistics
+static volatile ANALOG_KEYS_STATS_t stats;
+
+//Is a conversion of the keys in progress? (Set by AnalogKeys_Start)
+static volatile bool isConverting = false;
+
+#ifdef ANALOG_KEYS_REPLAY
+
+//Recorded travel of key 0, one sample per scan (press, partial lift, rapid re-press, release)
+static const uint16_t replayCurve[] = 
+{
+    0, 0, 20, 90, 210, 350, 470, 560, 600, 610, 600, 560, 510, 490, 500, 560, 
+    620, 640, 630, 540, 420, 300, 180, 70, 20, 0, 0, 0
+};
+
+//Position in the curve
+static uint8_t replayIndex = 0;
+
+#endif
+
+//Collect the raw sensor reading of a key, and start converting the next key
+static uint16_t AnalogKeys_read(uint8_t key)
+{
+#ifdef ANALOG_KEYS_REPLAY
+    if (key == 0)
+    {
+        uint16_t sample = replayCurve[replayIndex];
+        
+        replayIndex++;
+        if (replayIndex >= (sizeof(replayCurve) / sizeof(replayCurve[0])))
+        {
+            replayIndex = 0;
+        }
+        
+        return sample;
+    }
+    return 0;
+#else
+    //The first conversion is usually done by the time the key task runs
+    while (!ADC0_IsConversionDone())
+    {
+        ;
+    }
+    
+    uint16_t sample = ADC0_GetConversionResult();
+    
+    //Convert the next key while this one is processed
+    if ((key + 1) < ANALOG_KEYS_COUNT)
+    {
+        ADC0_ChannelSelect(channels[key + 1]);
+        ADC0_ConversionStart();
+    }
+    
+    return sample;
+#endif
+}
+
+//Convert a raw sensor reading to travel from the rest position
+static uint16_t AnalogKeys_toTravel(uint8_t key, uint16_t raw)
+{
+#ifdef ANALOG_KEYS_INVERTED
+    if (raw >= restPosition[key])
+    {
+        return 0;
+    }
+    return restPosition[key] - raw;
+#else
+    if (raw <= restPosition[key])
+    {
+        return 0;
+    }
+    return raw - restPosition[key];
+#endif
+}
+
+//Record a key press
+static void AnalogKeys_press(ANALOG_KEY_t* key, uint16_t position, bool isRapid)
+{
+    key->state = ANALOG_KEY_PRESSED;
+    key->turn = position;
+    
+    stats.presses++;
+    if (isRapid)
+    {
+        stats.rapidPresses++;
+    }
+    
+    stats.lastLatency = key->scans;
+    if (key->scans > stats.maxLatency)
+    {
+        stats.maxLatency = key->scans;
+    }
+}
+
+//Enable the ADC, calibrate the rest position of each key and clear the key states
+void AnalogKeys_Initialize(void)
+{
+#ifndef ANALOG_KEYS_REPLAY
+    //The ADC is only powered when analog keys are used
+    ADC0_Enable();
+#endif
+    isConverting = false;
+    
+    for (uint8_t i = 0; i < ANALOG_KEYS_COUNT; i++)
+    {
+#ifdef ANALOG_KEYS_REPLAY
+        restPosition[i] = 0;
+#else
+        //Keys must be up at power on
+        restPosition[i] = ADC0_GetConversion(channels[i]);
+#endif
+        travel[i] = 0;
+        keys[i].state = ANALOG_KEY_UP;
+        keys[i].turn = 0;
+        keys[i].actuation = ANALOG_KEYS_ACTUATION;
+        keys[i].scans = 0;
+    }
+    
+#ifdef ANALOG_KEYS_REPLAY
+    replayIndex = 0;
+#endif
+}
+
+//Set the actuation point of a key
+void AnalogKeys_SetActuation(uint8_t key, uint16_t position)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        keys[key].actuation = position;
+    }
+}
+
+//Start converting the first key
+void AnalogKeys_Start(void)
+{
+#ifndef ANALOG_KEYS_REPLAY
+    if (isConverting)
+    {
+        return;
+    }
+    
+    isConverting = true;
+    ADC0_ChannelSelect(channels[0]);
+    ADC0_ConversionStart();
+#endif
+}
+
+//Collect the conversion of each key and update its travel state
+uint8_t AnalogKeys_Scan(void)
+{
+    uint8_t pressed = 0x00;
+    
+#ifndef ANALOG_KEYS_REPLAY
+    //The interrupt did not start a conversion, because the last scan was still converting
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (!isConverting)
+        {
+            isConverting = true;
+            ADC0_ChannelSelect(channels[0]);
+            ADC0_ConversionStart();
+        }
+    }
+#endif
+    
+    for (uint8_t i = 0; i < ANALOG_KEYS_COUNT; i++)
+    {
+        ANALOG_KEY_t* key = &keys[i];
+        uint16_t position = AnalogKeys_toTravel(i, AnalogKeys_read(i));
+        
+        travel[i] = position;
+        
+        //Count scans from leaving the reset point for the latency statistics
+        if (position <= ANALOG_KEYS_RESET_POINT)
+        {
+            key->scans = 0;
+        }
+        else if (key->scans < UINT8_MAX)
+        {
+            key->scans++;
+        }
+        
+        switch (key->state)
+        {
+            case ANALOG_KEY_UP:
+            {
+                //Fixed actuation point
+                if (position >= key->actuation)
+                {
+                    AnalogKeys_press(key, position, false);
+                }
+                break;
+            }
+            case ANALOG_KEY_PRESSED:
+            {
+                //Track the deepest point, and release as soon as the key travels up by the delta
+                if (position > key->turn)
+                {
+                    key->turn = position;
+                }
+                else if ((position + ANALOG_KEYS_RAPID_DELTA) <= key->turn)
+                {
+                    key->state = ANALOG_KEY_RAPID_RELEASED;
+                    key->turn = position;
+                }
+                break;
+            }
+            case ANALOG_KEY_RAPID_RELEASED:
+            {
+                //Track the shallowest point, and press as soon as the key travels down by the delta
+                if (position < key->turn)
+                {
+                    key->turn = position;
+                }
+                else if (position >= (key->turn + ANALOG_KEYS_RAPID_DELTA))
+                {
+                    AnalogKeys_press(key, position, true);
+                }
+                break;
+            }
+            default:
+            {
+                //We shouldn't get here
+            }
+        }
+        
+        //Fully up - back to the fixed actuation point
+        if (position <= ANALOG_KEYS_RESET_POINT)
+        {
+            key->state = ANALOG_KEY_UP;
+        }
+        
+        if (key->state == ANALOG_KEY_PRESSED)
+        {
+            pressed |= (1 << i);
+        }
+    }
+    
+    //The next interrupt starts a new conversion
+    isConverting = false;
+    
+    return pressed;
+}
+
+//Returns the travel of a key from the last scan
+uint16_t AnalogKeys_GetTravel(uint8_t key)
+{
+    uint16_t value;
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        value = travel[key];
+    }
+    
+    return value;
+}
+
+//Copy and clear the statistics
+void AnalogKeys_GetStats(ANALOG_KEYS_STATS_t* copy)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *copy = stats;
+        
+        stats.presses = 0;
+        stats.rapidPresses = 0;
+        stats.lastLatency = 0;
+        stats.maxLatency = 0;
+    }
+}
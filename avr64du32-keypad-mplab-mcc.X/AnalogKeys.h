@@ -0,0 +1,74 @@
+#ifndef ANALOGKEYS_H
+#define	ANALOGKEYS_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+    //Number of analog (Hall-effect) keys (up to 8)
+#define ANALOG_KEYS_COUNT 2
+    
+    //ADC channel (MUXPOS) of each key
+#define ANALOG_KEYS_CHANNELS { 1, 3 }       //PD1 (AIN1), PD3 (AIN3)
+    
+    //If set, the sensor output falls as the key is pressed
+    //#define ANALOG_KEYS_INVERTED
+    
+    //Travel is in ADC counts from the rest position (4 samples are accumulated per conversion)
+    
+    //Default actuation point
+#define ANALOG_KEYS_ACTUATION 400
+    
+    //Rapid trigger - travel up (or down) from the turning point that releases (or presses) the key
+#define ANALOG_KEYS_RAPID_DELTA 80
+    
+    //Travel below which the key is fully up - the next press needs the actuation point again
+#define ANALOG_KEYS_RESET_POINT 60
+    
+    //If set, key samples are replayed from a recorded travel curve instead of the ADC
+    //#define ANALOG_KEYS_REPLAY
+    
+    //Analog key statistics
+    typedef struct {
+        //Number of key presses
+        uint16_t presses;
+        
+        //Presses from rapid trigger (without returning to the reset point)
+        uint16_t rapidPresses;
+        
+        //Scans from the key leaving the reset point to the last press
+        uint8_t lastLatency;
+        
+        //Worst scans from the key leaving the reset point to a press
+        uint8_t maxLatency;
+    } ANALOG_KEYS_STATS_t;
+    
+    //Enable the ADC, calibrate the rest position of each key and clear the key states
+    void AnalogKeys_Initialize(void);
+    
+    //Set the actuation point of a key
+    void AnalogKeys_SetActuation(uint8_t key, uint16_t travel);
+    
+    //Start converting the first key - call from the key scan interrupt
+    //Ignored while AnalogKeys_Scan is converting
+    void AnalogKeys_Start(void);
+    
+    //Collect the conversion of each key and update its travel state - call once per scan, from the key task
+    //Converts the other keys in turn (one conversion each)
+    //Returns a bitmap of the pressed keys (bit n = key n)
+    uint8_t AnalogKeys_Scan(void);
+    
+    //Returns the travel of a key from the last scan
+    uint16_t AnalogKeys_GetTravel(uint8_t key);
+    
+    //Copy and clear the statistics
+    void AnalogKeys_GetStats(ANALOG_KEYS_STATS_t* stats);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* ANALOGKEYS_H */
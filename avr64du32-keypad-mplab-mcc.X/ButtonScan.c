@@ -0,0 +1,78 @@
+#include "ButtonScan.h"
+
+#include "mcc_generated_files/system/system.h"
+
+//Map a pin of a port snapshot to a bit in the key bitmap
+#define BUTTON_SCAN_MAP(port, pin, bm) (((port) & (1 << (pin))) ? (bm) : 0)
+
+//Last raw sample
+static uint8_t lastSample = 0x00;
+
+//Debounced keys
+static uint8_t keys = 0x00;
+
+//Edges from the last update
+static uint8_t pressed = 0x00;
+static uint8_t released = 0x00;
+
+//Clear the debounce state
+void ButtonScan_Initialize(void)
+{
+    lastSample = 0x00;
+    keys = 0x00;
+    pressed = 0x00;
+    released = 0x00;
+}
+
+//Sample all buttons at once and return the raw key bitmap (1 = pressed)
+uint8_t ButtonScan_Sample(void)
+{
+    //Snapshot every port once, so all keys are from the same instant
+    uint8_t portA = VPORTA.IN;
+    uint8_t portD = VPORTD.IN;
+    uint8_t portF = VPORTF.IN;
+    
+    uint8_t sample = BUTTON_SCAN_MAP(portF, BUTTON_SCAN_SW0_PIN, BUTTON_SCAN_SW0_bm)
+            | BUTTON_SCAN_MAP(portD, BUTTON_SCAN_BUTTON1_PIN, BUTTON_SCAN_BUTTON1_bm)
+            | BUTTON_SCAN_MAP(portF, BUTTON_SCAN_BUTTON2_PIN, BUTTON_SCAN_BUTTON2_bm)
+            | BUTTON_SCAN_MAP(portA, BUTTON_SCAN_BUTTON3_PIN, BUTTON_SCAN_BUTTON3_bm)
+            | BUTTON_SCAN_MAP(portD, BUTTON_SCAN_BUTTON4_PIN, BUTTON_SCAN_BUTTON4_bm)
+            | BUTTON_SCAN_MAP(portD, BUTTON_SCAN_EXTERNAL_PIN, BUTTON_SCAN_EXTERNAL_bm);
+    
+    return sample ^ BUTTON_SCAN_ACTIVE_LOW_gm;
+}
+
+//Sample and debounce the buttons - call once per scan
+uint8_t ButtonScan_Update(void)
+{
+    uint8_t sample = ButtonScan_Sample();
+    
+    //Pressed now, or held and pressed on the last sample (a release needs 2 samples)
+    uint8_t next = sample | (lastSample & keys);
+    
+    pressed = next & ~keys;
+    released = keys & ~next;
+    
+    keys = next;
+    lastSample = sample;
+    
+    return keys;
+}
+
+//Raw sample from the last update
+uint8_t ButtonScan_GetSample(void)
+{
+    return lastSample;
+}
+
+//Buttons pressed by the last update
+uint8_t ButtonScan_GetPressed(void)
+{
+    return pressed;
+}
+
+//Buttons released by the last update
+uint8_t ButtonScan_GetReleased(void)
+{
+    return released;
+}
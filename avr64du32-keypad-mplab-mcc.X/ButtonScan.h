@@ -0,0 +1,70 @@
+#ifndef BUTTONSCAN_H
+#define	BUTTONSCAN_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+    
+    //If set, the external button is NC, not NO
+    //#define EXTERNAL_BUTTON_NC
+    
+    //Number of buttons in the key bitmap
+#define BUTTON_SCAN_COUNT 6
+    
+    //Bit of each button in the key bitmap (lowest bit has priority)
+#define BUTTON_SCAN_SW0_bp 0
+#define BUTTON_SCAN_EXTERNAL_bp 1
+#define BUTTON_SCAN_BUTTON1_bp 2
+#define BUTTON_SCAN_BUTTON2_bp 3
+#define BUTTON_SCAN_BUTTON3_bp 4
+#define BUTTON_SCAN_BUTTON4_bp 5
+    
+#define BUTTON_SCAN_SW0_bm (1 << BUTTON_SCAN_SW0_bp)
+#define BUTTON_SCAN_EXTERNAL_bm (1 << BUTTON_SCAN_EXTERNAL_bp)
+#define BUTTON_SCAN_BUTTON1_bm (1 << BUTTON_SCAN_BUTTON1_bp)
+#define BUTTON_SCAN_BUTTON2_bm (1 << BUTTON_SCAN_BUTTON2_bp)
+#define BUTTON_SCAN_BUTTON3_bm (1 << BUTTON_SCAN_BUTTON3_bp)
+#define BUTTON_SCAN_BUTTON4_bm (1 << BUTTON_SCAN_BUTTON4_bp)
+    
+    //Pin of each button (see pins.h)
+#define BUTTON_SCAN_SW0_PIN 6           //PF6
+#define BUTTON_SCAN_BUTTON1_PIN 5       //PD5
+#define BUTTON_SCAN_BUTTON2_PIN 4       //PF4
+#define BUTTON_SCAN_BUTTON3_PIN 7       //PA7
+#define BUTTON_SCAN_BUTTON4_PIN 2       //PD2
+#define BUTTON_SCAN_EXTERNAL_PIN 4      //PD4
+    
+    //Buttons that read low when pressed
+#ifndef EXTERNAL_BUTTON_NC
+#define BUTTON_SCAN_ACTIVE_LOW_gm BUTTON_SCAN_EXTERNAL_bm
+#else
+#define BUTTON_SCAN_ACTIVE_LOW_gm 0
+#endif
+    
+    //Clear the debounce state
+    void ButtonScan_Initialize(void);
+    
+    //Sample all buttons at once and return the raw key bitmap (1 = pressed)
+    uint8_t ButtonScan_Sample(void);
+    
+    //Sample and debounce the buttons - call once per scan
+    //Presses are reported at once, releases after 2 scans in a row
+    //Returns the debounced key bitmap
+    uint8_t ButtonScan_Update(void);
+    
+    //Raw sample from the last update
+    uint8_t ButtonScan_GetSample(void);
+    
+    //Buttons pressed by the last update
+    uint8_t ButtonScan_GetPressed(void);
+    
+    //Buttons released by the last update
+    uint8_t ButtonScan_GetReleased(void);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* BUTTONSCAN_H */
@@ -0,0 +1,270 @@
+#include "Combo.h"
+
+#include <util/atomic.h>
+
+#include "mcc_generated_files/usb/usb_hid/usb_hid_keycodes.h"
+#include "Timebase.h"
+
+//Keys of a combo, and what it does
+typedef struct {
+    KEY_ENGINE_KEYS_t keys;
+    KEYMAP_ACTION_t action;
+} COMBO_t;
+
+//Combo table
+static const COMBO_t combos[] = 
+{
+    //BUTTON1 + BUTTON2 - CTRL + A
+    { (1 << KEYMAP_BUTTON1) | (1 << KEYMAP_BUTTON2), { KEYMAP_ACTION_KEY, HID_MODIFIER_LEFT_CTRL, HID_A } },
+    
+    //BUTTON3 + BUTTON4 - CTRL + Y
+    { (1 << KEYMAP_BUTTON3) | (1 << KEYMAP_BUTTON4), { KEYMAP_ACTION_KEY, HID_MODIFIER_LEFT_CTRL, HID_Y } },
+    
+    //BUTTON1 + BUTTON2 + BUTTON3 - CTRL + S
+    { (1 << KEYMAP_BUTTON1) | (1 << KEYMAP_BUTTON2) | (1 << KEYMAP_BUTTON3), 
+            { KEYMAP_ACTION_KEY, HID_MODIFIER_LEFT_CTRL, HID_S } },
+};
+
+#define COMBO_COUNT (sizeof(combos) / sizeof(combos[0]))
+
+//Keys used by any combo
+static KEY_ENGINE_KEYS_t comboKeys = 0;
+
+//Keys pressed on the last scan
+static volatile KEY_ENGINE_KEYS_t lastKeys = 0;
+
+//Combo keys held back until the combo is resolved
+static volatile KEY_ENGINE_KEYS_t pendingKeys = 0;
+
+//Keys of a sent combo that are still held
+static volatile KEY_ENGINE_KEYS_t usedKeys = 0;
+
+//Scans since the first pending key was pressed
+static volatile uint8_t pendingScans = 0;
+
+//Scans before the pending keys are resolved
+static volatile uint8_t windowScans = (COMBO_WINDOW / KEY_ENGINE_SCAN_PERIOD);
+
+//Statistics
+static volatile COMBO_STATS_t stats;
+
+//Record the latency of a resolution
+static void Combo_recordLatency(bool isCombo)
+{
+    uint16_t latency = (uint16_t) pendingScans * KEY_ENGINE_SCAN_PERIOD;
+    
+    if (isCombo)
+    {
+        stats.combos++;
+        if (latency > stats.maxComboLatency)
+        {
+            stats.maxComboLatency = latency;
+        }
+    }
+    else
+    {
+        stats.singles++;
+        if (latency > stats.maxSingleLatency)
+        {
+            stats.maxSingleLatency = latency;
+        }
+    }
+}
+
+//Record the cost of a pass over the combo table
+static void Combo_recordPass(uint32_t cycles)
+{
+    if (cycles > UINT16_MAX)
+    {
+        cycles = UINT16_MAX;
+    }
+    
+    stats.passes++;
+    stats.totalCycles += cycles;
+    if (cycles > stats.maxCycles)
+    {
+        stats.maxCycles = cycles;
+    }
+}
+
+//Clear the combo state and load the default window
+void Combo_Initialize(void)
+{
+    comboKeys = 0;
+    for (uint8_t i = 0; i < COMBO_COUNT; i++)
+    {
+        comboKeys |= combos[i].keys;
+    }
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        Combo_Reset();
+        windowScans = (COMBO_WINDOW / KEY_ENGINE_SCAN_PERIOD);
+        
+        stats.combos = 0;
+        stats.singles = 0;
+        stats.maxComboLatency = 0;
+        stats.maxSingleLatency = 0;
+        stats.passes = 0;
+        stats.maxCycles = 0;
+        stats.totalCycles = 0;
+    }
+}
+
+//Release all keys without sending a combo
+void Combo_Reset(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        lastKeys = 0;
+        pendingKeys = 0;
+        usedKeys = 0;
+        pendingScans = 0;
+    }
+}
+
+//Set the combo window (ms)
+void Combo_SetWindow(uint16_t window)
+{
+    window /= KEY_ENGINE_SCAN_PERIOD;
+    
+    if (window == 0)
+    {
+        window = 1;
+    }
+    else if (window > UINT8_MAX)
+    {
+        window = UINT8_MAX;
+    }
+    
+    windowScans = window;
+}
+
+//Resolve combos from the pressed keys
+bool Combo_Scan(KEY_ENGINE_KEYS_t* keys, KEYMAP_ACTION_t* action)
+{
+    KEY_ENGINE_KEYS_t current = *keys;
+    KEY_ENGINE_KEYS_t pressed = current & ~lastKeys;
+    KEY_ENGINE_KEYS_t released = lastKeys & ~current;
+    KEY_ENGINE_KEYS_t singleKeys = 0;
+    bool isResolved = false;
+    bool isCombo = false;
+    
+    lastKeys = current;
+    
+    //Keys of a sent combo act on their own again once released
+    usedKeys &= current;
+    
+    if (pendingKeys)
+    {
+        if (pendingScans < UINT8_MAX)
+        {
+            pendingScans++;
+        }
+        
+        //Pressing another key or releasing a pending key ends the combo
+        if ((pressed & ~comboKeys) || (released & pendingKeys) || (pendingScans >= windowScans))
+        {
+            isResolved = true;
+        }
+    }
+    else
+    {
+        pendingScans = 0;
+    }
+    
+    if (!isResolved)
+    {
+        pendingKeys |= (pressed & comboKeys);
+    }
+    
+    if (pendingKeys)
+    {
+        //Find the combo that matches, and any larger combo that still could
+        uint8_t match = COMBO_COUNT;
+        bool isPossible = false;
+        uint32_t start, end;
+        
+        //Time the pass - its cost grows with the table
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            start = Timebase_GetCyclesFromISR();
+        }
+        
+        for (uint8_t i = 0; i < COMBO_COUNT; i++)
+        {
+            KEY_ENGINE_KEYS_t comboMask = combos[i].keys;
+            
+            if (comboMask == pendingKeys)
+            {
+                match = i;
+            }
+            else if ((comboMask & pendingKeys) == pendingKeys)
+            {
+                isPossible = true;
+            }
+        }
+        
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            end = Timebase_GetCyclesFromISR();
+        }
+        Combo_recordPass(end - start);
+        
+        //No larger combo can match - resolve now instead of waiting for the window
+        if (!isPossible)
+        {
+            isResolved = true;
+        }
+        
+        if (isResolved)
+        {
+            if (match < COMBO_COUNT)
+            {
+                *action = combos[match].action;
+                usedKeys |= (pendingKeys & current);
+                isCombo = true;
+            }
+            else
+            {
+                //Pass the keys on, even if they were released while pending
+                singleKeys = pendingKeys;
+            }
+            
+            Combo_recordLatency(isCombo);
+            pendingKeys = 0;
+        }
+    }
+    
+    *keys = (current & ~(pendingKeys | usedKeys)) | singleKeys;
+    return isCombo;
+}
+
+//Returns true while keys are held back
+bool Combo_IsActive(void)
+{
+    return ((pendingKeys != 0) || (usedKeys != 0));
+}
+
+//Returns the number of combos in the table
+uint8_t Combo_GetCount(void)
+{
+    return COMBO_COUNT;
+}
+
+//Copy and clear the statistics
+void Combo_GetStats(COMBO_STATS_t* copy)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *copy = stats;
+        
+        stats.combos = 0;
+        stats.singles = 0;
+        stats.maxComboLatency = 0;
+        stats.maxSingleLatency = 0;
+        stats.passes = 0;
+        stats.maxCycles = 0;
+        stats.totalCycles = 0;
+    }
+}
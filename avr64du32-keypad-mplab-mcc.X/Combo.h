@@ -0,0 +1,64 @@
+#ifndef COMBO_H
+#define	COMBO_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+#include "KeyEngine.h"
+#include "Keymap.h"
+    
+    //Default combo window - combo keys must all be pressed within this time (ms)
+#define COMBO_WINDOW 50
+    
+    //Combo statistics
+    //Latency is the time a key was held back before it was resolved (ms)
+    typedef struct {
+        //Combos sent
+        uint16_t combos;
+        
+        //Keys released as single keys, because no combo matched
+        uint16_t singles;
+        
+        //Worst latency of each resolution
+        uint16_t maxComboLatency;
+        uint16_t maxSingleLatency;
+        
+        //Passes over the combo table, and the CPU cycles they took
+        //Includes any interrupt that ran during a pass
+        uint16_t passes;
+        uint16_t maxCycles;
+        uint32_t totalCycles;
+    } COMBO_STATS_t;
+    
+    //Clear the combo state and load the default window
+    void Combo_Initialize(void);
+    
+    //Release all keys without sending a combo (e.g. when VBUS is removed)
+    void Combo_Reset(void);
+    
+    //Set the combo window (ms)
+    void Combo_SetWindow(uint16_t window);
+    
+    //Resolve combos from the pressed keys - call once per scan, before KeyEngine_Scan
+    //keys is updated to the keys that act on their own
+    //Returns true if a combo was completed, and its action in action
+    bool Combo_Scan(KEY_ENGINE_KEYS_t* keys, KEYMAP_ACTION_t* action);
+    
+    //Returns true while keys are held back
+    bool Combo_IsActive(void);
+    
+    //Returns the number of combos in the table
+    uint8_t Combo_GetCount(void);
+    
+    //Copy and clear the statistics
+    void Combo_GetStats(COMBO_STATS_t* stats);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* COMBO_H */
@@ -0,0 +1,119 @@
+#include "IsrTiming.h"
+
+#include <avr/io.h>
+#include <util/atomic.h>
+
+#include "Timebase.h"
+
+//Budget of each interrupt
+static const uint16_t budgets[ISR_TIMING_COUNT] = 
+{
+    ISR_TIMING_BUDGET_RTC, ISR_TIMING_BUDGET_AC0, ISR_TIMING_BUDGET_USB0_BUS, ISR_TIMING_BUDGET_USB0_TRNCOMPL, 
+    ISR_TIMING_BUDGET_TCB0, ISR_TIMING_BUDGET_PIT, ISR_TIMING_BUDGET_TCB1
+};
+
+//Statistics
+static volatile ISR_TIMING_STATS_t stats[ISR_TIMING_COUNT];
+
+//Has an interrupt gone over its budget? (Only cleared on reset)
+static volatile bool hasOverrun = false;
+
+//CPU cycles spent in the level 1 interrupt
+static volatile uint32_t level1Cycles = 0;
+
+//Returns the cycle count, less the cycles spent in the level 1 interrupt
+static uint32_t IsrTiming_read(void)
+{
+    uint32_t cycles;
+    
+    //A level 1 interrupt can run during a level 0 one
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        cycles = Timebase_GetCyclesFromISR() - level1Cycles;
+    }
+    
+    return cycles;
+}
+
+//Clear the statistics
+void IsrTiming_Initialize(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        for (uint8_t i = 0; i < ISR_TIMING_COUNT; i++)
+        {
+            stats[i].runs = 0;
+            stats[i].maxCycles = 0;
+            stats[i].overruns = 0;
+        }
+        
+        hasOverrun = false;
+        level1Cycles = 0;
+    }
+}
+
+//Call first in the interrupt
+uint32_t IsrTiming_Start(void)
+{
+    return IsrTiming_read();
+}
+
+//Call last in the interrupt
+void IsrTiming_End(ISR_TIMING_ID isr, uint32_t start)
+{
+    uint32_t cycles = IsrTiming_read() - start;
+    
+    //Leave this run out of any level 0 interrupt it stopped
+    if (CPUINT.STATUS & CPUINT_LVL1EX_bm)
+    {
+        level1Cycles += cycles;
+    }
+    
+    if (cycles > UINT16_MAX)
+    {
+        cycles = UINT16_MAX;
+    }
+    
+    stats[isr].runs++;
+    
+    if (cycles > stats[isr].maxCycles)
+    {
+        stats[isr].maxCycles = cycles;
+    }
+    
+    if (cycles > budgets[isr])
+    {
+        stats[isr].overruns++;
+        hasOverrun = true;
+    
+#ifdef ISR_TIMING_BREAK_ON_OVERRUN
+        //Stop in the debugger with the interrupt still on the stack
+        __asm__ __volatile__ ("break");
+#endif
+    }
+}
+
+//Returns the budget of an interrupt
+uint16_t IsrTiming_GetBudget(ISR_TIMING_ID isr)
+{
+    return budgets[isr];
+}
+
+//Returns true if any interrupt has gone over its budget
+bool IsrTiming_HasOverrun(void)
+{
+    return hasOverrun;
+}
+
+//Copy and clear the statistics of an interrupt
+void IsrTiming_GetStats(ISR_TIMING_ID isr, ISR_TIMING_STATS_t* copy)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *copy = stats[isr];
+        
+        stats[isr].runs = 0;
+        stats[isr].maxCycles = 0;
+        stats[isr].overruns = 0;
+    }
+}
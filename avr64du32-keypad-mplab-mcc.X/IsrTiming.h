@@ -0,0 +1,64 @@
+#ifndef ISRTIMING_H
+#define	ISRTIMING_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+    //Budget of each interrupt (CPU cycles, 20 per us)
+#define ISR_TIMING_BUDGET_RTC 4000
+#define ISR_TIMING_BUDGET_AC0 200
+#define ISR_TIMING_BUDGET_USB0_BUS 200
+#define ISR_TIMING_BUDGET_USB0_TRNCOMPL 200
+#define ISR_TIMING_BUDGET_TCB0 600
+#define ISR_TIMING_BUDGET_TCB1 4000
+#define ISR_TIMING_BUDGET_PIT 200
+    
+    //If set, the CPU stops at a breakpoint when an interrupt goes over its budget
+    //#define ISR_TIMING_BREAK_ON_OVERRUN
+    
+    //Timed interrupts - each has its own statistics, as a level 1 interrupt can stop a level 0 one part way
+    typedef enum {
+        ISR_TIMING_RTC = 0, ISR_TIMING_AC0, ISR_TIMING_USB0_BUS, ISR_TIMING_USB0_TRNCOMPL, ISR_TIMING_TCB0, ISR_TIMING_PIT, 
+        ISR_TIMING_TCB1, ISR_TIMING_COUNT
+    } ISR_TIMING_ID;
+    
+    //Execution time statistics of an interrupt
+    typedef struct {
+        //Times the interrupt ran
+        uint16_t runs;
+    
+        //Longest run (CPU cycles)
+        uint16_t maxCycles;
+    
+        //Runs over the budget
+        uint16_t overruns;
+    } ISR_TIMING_STATS_t;
+    
+    //Clear the statistics
+    void IsrTiming_Initialize(void);
+    
+    //Call first in the interrupt - returns the start time for IsrTiming_End
+    //The time spent in the level 1 interrupt is left out, so a level 0 interrupt is not charged for it
+    uint32_t IsrTiming_Start(void);
+    
+    //Call last in the interrupt - records the time since start
+    void IsrTiming_End(ISR_TIMING_ID isr, uint32_t start);
+    
+    //Returns the budget of an interrupt (CPU cycles)
+    uint16_t IsrTiming_GetBudget(ISR_TIMING_ID isr);
+    
+    //Returns true if any interrupt has gone over its budget since power on
+    bool IsrTiming_HasOverrun(void);
+    
+    //Copy and clear the statistics of an interrupt
+    void IsrTiming_GetStats(ISR_TIMING_ID isr, ISR_TIMING_STATS_t* stats);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* ISRTIMING_H */
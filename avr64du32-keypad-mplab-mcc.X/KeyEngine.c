@@ -0,0 +1,458 @@
+#include "KeyEngine.h"
+
+#include <util/atomic.h>
+
+#include "mcc_generated_files/usb/usb_hid/usb_hid_keycodes.h"
+#include "KeyReporting.h"
+#include "Macro.h"
+
+#if KEYMAP_KEYS > 16
+#error "The key bitmap holds up to 16 keys"
+#endif
+
+//State of each key
+typedef enum {
+    KEY_ENGINE_IDLE = 0, KEY_ENGINE_PRESSED, KEY_ENGINE_UNDECIDED, KEY_ENGINE_HOLDING
+} KEY_ENGINE_STATE;
+
+//Which path decided a dual-role key
+typedef enum {
+    KEY_ENGINE_DECIDED_TAP = 0, KEY_ENGINE_DECIDED_HOLD, KEY_ENGINE_DECIDED_EARLY_HOLD
+} KEY_ENGINE_DECISION;
+
+//Key states
+static volatile KEY_ENGINE_STATE states[KEYMAP_KEYS];
+
+//Action of each key, from the layer active when it was pressed
+static volatile KEYMAP_ACTION_t actions[KEYMAP_KEYS];
+
+//Scans since each key was pressed (stops at UINT8_MAX)
+static volatile uint8_t heldScans[KEYMAP_KEYS];
+
+//Keys pressed on the last scan
+static volatile KEY_ENGINE_KEYS_t lastKeys = 0;
+
+//Auto-repeat delay and rate of each key (scans, delay of 0 = off)
+static volatile uint8_t repeatDelay[KEYMAP_KEYS];
+static volatile uint8_t repeatRate[KEYMAP_KEYS];
+
+//Scans until each held key repeats
+static volatile uint8_t repeatScans[KEYMAP_KEYS];
+
+//Scans before a dual-role key becomes a hold
+static volatile uint8_t tappingTerm = (KEY_ENGINE_TAPPING_TERM / KEY_ENGINE_SCAN_PERIOD);
+
+//Modifiers and layer of the keys being held
+static volatile uint8_t heldModifiers = HID_MODIFIER_NONE;
+static volatile uint8_t activeLayer = 0;
+
+//Modifiers in the last report
+static volatile uint8_t sentModifiers = HID_MODIFIER_NONE;
+
+//Was a key down in the last report?
+static volatile bool isKeyDown = false;
+
+//Taps waiting to be reported
+static volatile KEYMAP_ACTION_t queue[KEY_ENGINE_QUEUE_SIZE];
+static volatile uint8_t queueHead = 0;
+static volatile uint8_t queueCount = 0;
+
+//Statistics
+static volatile KEY_ENGINE_STATS_t stats;
+
+//Queue a tap of action
+static void KeyEngine_queueTap(KEYMAP_ACTION_t action)
+{
+    if (queueCount >= KEY_ENGINE_QUEUE_SIZE)
+    {
+        stats.dropped++;
+        return;
+    }
+    
+    queue[(queueHead + queueCount) % KEY_ENGINE_QUEUE_SIZE] = action;
+    queueCount++;
+}
+
+//Work out the modifiers and layer from the keys being held
+static void KeyEngine_updateHeld(void)
+{
+    heldModifiers = HID_MODIFIER_NONE;
+    activeLayer = 0;
+    
+    for (uint8_t key = 0; key < KEYMAP_KEYS; key++)
+    {
+        if (states[key] != KEY_ENGINE_HOLDING)
+        {
+            continue;
+        }
+        
+        if (actions[key].type == KEYMAP_ACTION_TAP_HOLD)
+        {
+            heldModifiers |= actions[key].modifier;
+        }
+        else if (actions[key].modifier > activeLayer)
+        {
+            //Highest layer wins
+            activeLayer = actions[key].modifier;
+        }
+    }
+}
+
+//Record the latency a decision added to the key output
+static void KeyEngine_recordDecision(KEY_ENGINE_DECISION decision, uint8_t scans)
+{
+    uint16_t latency = (uint16_t) scans * KEY_ENGINE_SCAN_PERIOD;
+    
+    switch (decision)
+    {
+        case KEY_ENGINE_DECIDED_TAP:
+        {
+            stats.taps++;
+            if (latency > stats.maxTapLatency)
+            {
+                stats.maxTapLatency = latency;
+            }
+            break;
+        }
+        case KEY_ENGINE_DECIDED_HOLD:
+        {
+            stats.holds++;
+            if (latency > stats.maxHoldLatency)
+            {
+                stats.maxHoldLatency = latency;
+            }
+            break;
+        }
+        case KEY_ENGINE_DECIDED_EARLY_HOLD:
+        {
+            stats.earlyHolds++;
+            if (latency > stats.maxEarlyHoldLatency)
+            {
+                stats.maxEarlyHoldLatency = latency;
+            }
+            break;
+        }
+        default:
+        {
+            
+        }
+    }
+}
+
+//Another key was pressed - every undecided key is a hold
+static void KeyEngine_decideHolds(void)
+{
+    bool isChanged = false;
+    
+    for (uint8_t key = 0; key < KEYMAP_KEYS; key++)
+    {
+        if (states[key] == KEY_ENGINE_UNDECIDED)
+        {
+            states[key] = KEY_ENGINE_HOLDING;
+            KeyEngine_recordDecision(KEY_ENGINE_DECIDED_EARLY_HOLD, heldScans[key]);
+            isChanged = true;
+        }
+    }
+    
+    if (isChanged)
+    {
+        KeyEngine_updateHeld();
+    }
+}
+
+//Returns true if the action is a dual-role action
+static inline bool KeyEngine_isDualRole(KEYMAP_ACTION_t action)
+{
+    return ((action.type == KEYMAP_ACTION_TAP_HOLD) || (action.type == KEYMAP_ACTION_TAP_LAYER));
+}
+
+//Convert a time (ms) into scans, limited to min and UINT8_MAX
+static uint8_t KeyEngine_toScans(uint16_t time, uint8_t min)
+{
+    time /= KEY_ENGINE_SCAN_PERIOD;
+    
+    if (time < min)
+    {
+        time = min;
+    }
+    else if (time > UINT8_MAX)
+    {
+        time = UINT8_MAX;
+    }
+    
+    return time;
+}
+
+//Repeat a held key once its delay (then rate) has passed
+static void KeyEngine_repeat(uint8_t key)
+{
+    if ((repeatDelay[key] == 0) || (actions[key].type != KEYMAP_ACTION_KEY))
+    {
+        return;
+    }
+    
+    if (repeatScans[key] > 1)
+    {
+        repeatScans[key]--;
+        return;
+    }
+    
+    //Only repeat when the last tap has been reported, so repeats are evenly paced
+    if ((queueCount == 0) && (!isKeyDown))
+    {
+        KeyEngine_queueTap(actions[key]);
+        repeatScans[key] = repeatRate[key];
+        stats.repeats++;
+    }
+}
+
+//Clear the key states and load the default tapping term
+void KeyEngine_Initialize(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        KeyEngine_Reset();
+        tappingTerm = (KEY_ENGINE_TAPPING_TERM / KEY_ENGINE_SCAN_PERIOD);
+        
+        for (uint8_t key = 0; key < KEYMAP_KEYS; key++)
+        {
+#ifdef KEY_ENGINE_REPEAT_ENABLE
+            repeatDelay[key] = KeyEngine_toScans(KEY_ENGINE_REPEAT_DELAY, 1);
+            repeatRate[key] = KeyEngine_toScans(KEY_ENGINE_REPEAT_RATE, 2);
+#else
+            repeatDelay[key] = 0;
+            repeatRate[key] = 0;
+#endif
+        }
+        
+        stats.taps = 0;
+        stats.holds = 0;
+        stats.earlyHolds = 0;
+        stats.dropped = 0;
+        stats.repeats = 0;
+        stats.maxTapLatency = 0;
+        stats.maxHoldLatency = 0;
+        stats.maxEarlyHoldLatency = 0;
+    }
+}
+
+//Release all keys without reporting them
+void KeyEngine_Reset(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        for (uint8_t key = 0; key < KEYMAP_KEYS; key++)
+        {
+            states[key] = KEY_ENGINE_IDLE;
+            heldScans[key] = 0;
+        }
+        
+        lastKeys = 0;
+        heldModifiers = HID_MODIFIER_NONE;
+        sentModifiers = HID_MODIFIER_NONE;
+        activeLayer = 0;
+        isKeyDown = false;
+        queueHead = 0;
+        queueCount = 0;
+    }
+}
+
+//Set the tapping term (ms)
+void KeyEngine_SetTappingTerm(uint16_t term)
+{
+    //heldScans stops at UINT8_MAX
+    if (term >= (UINT8_MAX * KEY_ENGINE_SCAN_PERIOD))
+    {
+        term = (UINT8_MAX - 1) * KEY_ENGINE_SCAN_PERIOD;
+    }
+    
+    tappingTerm = KeyEngine_toScans(term, 1);
+}
+
+//Set the auto-repeat of a key (ms)
+void KeyEngine_SetRepeat(uint8_t key, uint16_t delay, uint16_t rate)
+{
+    if (key >= KEYMAP_KEYS)
+    {
+        return;
+    }
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        repeatDelay[key] = (delay == 0) ? 0 : KeyEngine_toScans(delay, 1);
+        
+        //A repeat needs a scan for the press and a scan for the release
+        repeatRate[key] = KeyEngine_toScans(rate, 2);
+    }
+}
+
+//Update the key states from the pressed keys
+void KeyEngine_Scan(KEY_ENGINE_KEYS_t keys)
+{
+    KEY_ENGINE_KEYS_t pressed = keys & ~lastKeys;
+    KEY_ENGINE_KEYS_t released = lastKeys & ~keys;
+    bool isHeldChanged = false;
+    
+    lastKeys = keys;
+    
+    //Any new key press decides the undecided keys before it is looked up
+    if (pressed)
+    {
+        KeyEngine_decideHolds();
+    }
+    
+    for (uint8_t key = 0; key < KEYMAP_KEYS; key++)
+    {
+        KEY_ENGINE_KEYS_t mask = (1 << key);
+        
+        if (pressed & mask)
+        {
+            //Resolve the action now, so changing layers does not change a held key
+            actions[key] = Keymap_Lookup(activeLayer, key);
+            heldScans[key] = 0;
+            repeatScans[key] = repeatDelay[key];
+            
+            if (KeyEngine_isDualRole(actions[key]))
+            {
+                states[key] = KEY_ENGINE_UNDECIDED;
+            }
+            else if (actions[key].type == KEYMAP_ACTION_MACRO_RECORD)
+            {
+                //Macro keys act at once and send nothing themselves
+                Macro_ToggleRecord();
+                states[key] = KEY_ENGINE_PRESSED;
+            }
+            else if (actions[key].type == KEYMAP_ACTION_MACRO_PLAY)
+            {
+                Macro_Play();
+                states[key] = KEY_ENGINE_PRESSED;
+            }
+            else
+            {
+                KeyEngine_queueTap(actions[key]);
+                states[key] = KEY_ENGINE_PRESSED;
+            }
+        }
+        else if (released & mask)
+        {
+            if (states[key] == KEY_ENGINE_UNDECIDED)
+            {
+                //Released within the tapping term - the tap key is sent now
+                KeyEngine_recordDecision(KEY_ENGINE_DECIDED_TAP, heldScans[key]);
+                KeyEngine_queueTap(actions[key]);
+            }
+            else if (states[key] == KEY_ENGINE_HOLDING)
+            {
+                isHeldChanged = true;
+            }
+            
+            states[key] = KEY_ENGINE_IDLE;
+        }
+        else if (states[key] != KEY_ENGINE_IDLE)
+        {
+            if (heldScans[key] < UINT8_MAX)
+            {
+                heldScans[key]++;
+            }
+            
+            if ((states[key] == KEY_ENGINE_UNDECIDED) && (heldScans[key] >= tappingTerm))
+            {
+                //Held for the tapping term
+                KeyEngine_recordDecision(KEY_ENGINE_DECIDED_HOLD, heldScans[key]);
+                states[key] = KEY_ENGINE_HOLDING;
+                isHeldChanged = true;
+            }
+            else if (states[key] == KEY_ENGINE_PRESSED)
+            {
+                KeyEngine_repeat(key);
+            }
+        }
+    }
+    
+    if (isHeldChanged)
+    {
+        KeyEngine_updateHeld();
+    }
+}
+
+//Tap a key outside the keymap
+void KeyEngine_Tap(uint8_t modifier, uint8_t keycode)
+{
+    KEYMAP_ACTION_t action = { KEYMAP_ACTION_KEY, modifier, keycode };
+    
+    KeyEngine_TapAction(action);
+}
+
+//Tap an action outside the keymap
+void KeyEngine_TapAction(KEYMAP_ACTION_t action)
+{
+    //Counts as another key for the undecided keys
+    KeyEngine_decideHolds();
+    KeyEngine_queueTap(action);
+}
+
+//Write the next report to keyReport
+bool KeyEngine_GetReport(USB_KEYBOARD_REPORT_DATA_t* keyReport)
+{
+    if (isKeyDown)
+    {
+        //Release the tap, but keep the held modifiers
+        KeyReport_clearReport(keyReport);
+        (*keyReport).Modifier = heldModifiers;
+        sentModifiers = heldModifiers;
+        isKeyDown = false;
+        return true;
+    }
+    
+    while (queueCount != 0)
+    {
+        KEYMAP_ACTION_t action = queue[queueHead];
+        
+        queueHead = (queueHead + 1) % KEY_ENGINE_QUEUE_SIZE;
+        queueCount--;
+        
+        KeyReport_clearReport(keyReport);
+        if (Keymap_Apply(action, keyReport))
+        {
+            (*keyReport).Modifier |= heldModifiers;
+            sentModifiers = heldModifiers;
+            isKeyDown = true;
+            return true;
+        }
+    }
+    
+    if (sentModifiers != heldModifiers)
+    {
+        //A hold started or ended
+        KeyReport_clearReport(keyReport);
+        (*keyReport).Modifier = heldModifiers;
+        sentModifiers = heldModifiers;
+        return true;
+    }
+    
+    return false;
+}
+
+//Returns true while a key is pressed or a report is waiting
+bool KeyEngine_IsActive(void)
+{
+    return ((lastKeys != 0) || (isKeyDown) || (queueCount != 0) || (sentModifiers != heldModifiers));
+}
+
+//Copy and clear the statistics
+void KeyEngine_GetStats(KEY_ENGINE_STATS_t* copy)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *copy = stats;
+        
+        stats.taps = 0;
+        stats.holds = 0;
+        stats.earlyHolds = 0;
+        stats.dropped = 0;
+        stats.repeats = 0;
+        stats.maxTapLatency = 0;
+        stats.maxHoldLatency = 0;
+        stats.maxEarlyHoldLatency = 0;
+    }
+}
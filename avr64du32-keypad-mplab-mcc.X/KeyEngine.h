@@ -0,0 +1,95 @@
+#ifndef KEYENGINE_H
+#define	KEYENGINE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+#include "mcc_generated_files/usb/usb_hid/usb_protocol_hid.h"
+#include "Keymap.h"
+    
+    //Time between key scans (ms)
+#define KEY_ENGINE_SCAN_PERIOD 5
+    
+    //Default tapping term - a dual-role key held longer than this is a hold (ms)
+#define KEY_ENGINE_TAPPING_TERM 200
+    
+    //Number of taps waiting to be reported
+#define KEY_ENGINE_QUEUE_SIZE 4
+    
+    //If set, held keys repeat on the device instead of relying on the host auto-repeat
+    //#define KEY_ENGINE_REPEAT_ENABLE
+    
+    //Default time from a key press to the first repeat (ms)
+#define KEY_ENGINE_REPEAT_DELAY 500
+    
+    //Default time between repeats (ms) - each repeat takes 2 scans (press and release)
+#define KEY_ENGINE_REPEAT_RATE 40
+    
+    //Key bitmap (bit n = keymap key n)
+    typedef uint16_t KEY_ENGINE_KEYS_t;
+    
+    //Dual-role decision statistics
+    //Latency is the time a decision added to the key output (ms)
+    typedef struct {
+        //Released within the tapping term
+        uint16_t taps;
+        
+        //Held for the tapping term
+        uint16_t holds;
+        
+        //Decided as a hold early, because another key was pressed
+        uint16_t earlyHolds;
+        
+        //Taps lost because the queue was full
+        uint8_t dropped;
+        
+        //Repeats of held keys
+        uint16_t repeats;
+        
+        //Worst latency of each decision
+        uint16_t maxTapLatency;
+        uint16_t maxHoldLatency;
+        uint16_t maxEarlyHoldLatency;
+    } KEY_ENGINE_STATS_t;
+    
+    //Clear the key states and load the default tapping term
+    void KeyEngine_Initialize(void);
+    
+    //Release all keys without reporting them (e.g. when VBUS is removed)
+    void KeyEngine_Reset(void);
+    
+    //Set the tapping term (ms)
+    void KeyEngine_SetTappingTerm(uint16_t term);
+    
+    //Set the auto-repeat of a key (ms) - a delay of 0 turns repeat off for the key
+    //Text and dual-role keys do not repeat
+    void KeyEngine_SetRepeat(uint8_t key, uint16_t delay, uint16_t rate);
+    
+    //Update the key states from the pressed keys - call once per scan
+    void KeyEngine_Scan(KEY_ENGINE_KEYS_t keys);
+    
+    //Tap a key outside the keymap (e.g. the key matrix) - call after KeyEngine_Scan
+    void KeyEngine_Tap(uint8_t modifier, uint8_t keycode);
+    
+    //Tap an action outside the keymap (e.g. a combo) - call after KeyEngine_Scan
+    void KeyEngine_TapAction(KEYMAP_ACTION_t action);
+    
+    //Write the next report to keyReport
+    //Returns false if there is nothing to report
+    bool KeyEngine_GetReport(USB_KEYBOARD_REPORT_DATA_t* keyReport);
+    
+    //Returns true while a key is pressed or a report is waiting
+    bool KeyEngine_IsActive(void);
+    
+    //Copy and clear the statistics
+    void KeyEngine_GetStats(KEY_ENGINE_STATS_t* stats);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* KEYENGINE_H */
@@ -0,0 +1,125 @@
+#include "KeyEventQueue.h"
+
+#include <string.h>
+#include <util/atomic.h>
+
+#include "usb_peripheral.h"
+
+#if (KEY_EVENT_QUEUE_SIZE & (KEY_EVENT_QUEUE_SIZE - 1)) || (KEY_EVENT_QUEUE_SIZE > 128)
+#error "KEY_EVENT_QUEUE_SIZE must be a power of 2, up to 128"
+#endif
+
+//Indexes run freely and are masked on use, so a full queue is head - tail == size
+#define KEY_EVENT_QUEUE_MASK (KEY_EVENT_QUEUE_SIZE - 1)
+
+//Frame numbers are 11 bits
+#define KEY_EVENT_FRAME_MASK 0x7FF
+
+//Events
+static volatile KEY_EVENT_t events[KEY_EVENT_QUEUE_SIZE];
+
+//Next event to write - only changed by the producer
+static volatile uint8_t head = 0;
+
+//Next event to read - only changed by the consumer
+static volatile uint8_t tail = 0;
+
+//Statistics
+static volatile KEY_EVENT_QUEUE_STATS_t stats;
+
+//Empty the queue
+void KeyEventQueue_Initialize(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        head = 0;
+        tail = 0;
+        
+        stats.maxDepth = 0;
+        stats.fullCount = 0;
+        stats.maxDelay = 0;
+    }
+}
+
+//Producer - Returns true if there is no room for another event
+bool KeyEventQueue_IsFull(void)
+{
+    return ((uint8_t)(head - tail) >= KEY_EVENT_QUEUE_SIZE);
+}
+
+//Producer - Add a report
+bool KeyEventQueue_Push(const USB_KEYBOARD_REPORT_DATA_t* report)
+{
+    //Single byte reads and writes are atomic on AVR
+    uint8_t index = head;
+    uint8_t depth = (uint8_t)(index - tail);
+    
+    if (depth >= KEY_EVENT_QUEUE_SIZE)
+    {
+        stats.fullCount++;
+        return false;
+    }
+    
+    events[index & KEY_EVENT_QUEUE_MASK].frame = USB_FrameNumberGet();
+    memcpy((void*) &events[index & KEY_EVENT_QUEUE_MASK].report, report, sizeof(USB_KEYBOARD_REPORT_DATA_t));
+    
+    if (depth >= stats.maxDepth)
+    {
+        stats.maxDepth = depth + 1;
+    }
+    
+    //Publish the event last - the consumer can read it from here on
+    head = index + 1;
+    
+    return true;
+}
+
+//Consumer - Returns true if there are no events
+bool KeyEventQueue_IsEmpty(void)
+{
+    return (head == tail);
+}
+
+//Consumer - Remove the oldest event
+bool KeyEventQueue_Pop(KEY_EVENT_t* event)
+{
+    uint8_t index = tail;
+    
+    if (head == index)
+    {
+        return false;
+    }
+    
+    memcpy(event, (const void*) &events[index & KEY_EVENT_QUEUE_MASK], sizeof(KEY_EVENT_t));
+    
+    //Free the slot only after it has been copied
+    tail = index + 1;
+    
+    //Only the consumer writes maxDelay
+    uint16_t delay = (USB_FrameNumberGet() - event->frame) & KEY_EVENT_FRAME_MASK;
+    if (delay > stats.maxDelay)
+    {
+        stats.maxDelay = delay;
+    }
+    
+    return true;
+}
+
+//Consumer - Discard all events
+void KeyEventQueue_Clear(void)
+{
+    tail = head;
+}
+
+//Copy and clear the statistics
+void KeyEventQueue_GetStats(KEY_EVENT_QUEUE_STATS_t* copy)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *copy = stats;
+        
+        stats.maxDepth = 0;
+        stats.fullCount = 0;
+        stats.maxDelay = 0;
+    }
+}
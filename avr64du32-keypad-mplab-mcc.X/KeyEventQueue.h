@@ -0,0 +1,64 @@
+#ifndef KEYEVENTQUEUE_H
+#define	KEYEVENTQUEUE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+#include "mcc_generated_files/usb/usb_hid/usb_protocol_hid.h"
+    
+    //Number of events in the queue (power of 2, up to 128)
+#define KEY_EVENT_QUEUE_SIZE 8
+    
+    //Keyboard report, and the USB frame it was sampled in
+    typedef struct {
+        uint16_t frame;
+        USB_KEYBOARD_REPORT_DATA_t report;
+    } KEY_EVENT_t;
+    
+    //Queue statistics
+    typedef struct {
+        //Most events in the queue at once
+        uint8_t maxDepth;
+        
+        //Pushes refused because the queue was full
+        uint16_t fullCount;
+        
+        //Worst frames (1 ms) from push to pop
+        uint16_t maxDelay;
+    } KEY_EVENT_QUEUE_STATS_t;
+    
+    //The queue has one producer (the key task) and one consumer (the USB task)
+    //Neither side disables interrupts to pass events - each side only writes its own index
+    
+    //Empty the queue
+    void KeyEventQueue_Initialize(void);
+    
+    //Producer - Returns true if there is no room for another event
+    bool KeyEventQueue_IsFull(void);
+    
+    //Producer - Add a report, stamped with the current USB frame
+    //Returns false if the queue is full
+    bool KeyEventQueue_Push(const USB_KEYBOARD_REPORT_DATA_t* report);
+    
+    //Consumer - Returns true if there are no events
+    bool KeyEventQueue_IsEmpty(void);
+    
+    //Consumer - Remove the oldest event
+    //Returns false if the queue is empty
+    bool KeyEventQueue_Pop(KEY_EVENT_t* event);
+    
+    //Consumer - Discard all events (e.g. when VBUS is removed)
+    void KeyEventQueue_Clear(void);
+    
+    //Consumer - Copy and clear the statistics
+    void KeyEventQueue_GetStats(KEY_EVENT_QUEUE_STATS_t* stats);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* KEYEVENTQUEUE_H */
@@ -0,0 +1,194 @@
+#include "KeyMatrix.h"
+
+#include "mcc_generated_files/system/system.h"
+
+#include <util/atomic.h>
+#include <util/delay.h>
+
+#if (KEY_MATRIX_ROW_MASK & KEY_MATRIX_ROW_BOARD_PINS) || (KEY_MATRIX_COL_LOW_MASK & KEY_MATRIX_COL_LOW_BOARD_PINS) \
+        || (KEY_MATRIX_COL_HIGH_MASK & KEY_MATRIX_COL_HIGH_BOARD_PINS)
+#error "The key matrix pins overlap pins used by the board"
+#endif
+
+//Row pin masks
+static const uint8_t rowPins[KEY_MATRIX_ROWS] = KEY_MATRIX_ROW_PINS;
+
+//Keys pressed on the last scan
+static volatile KEY_MATRIX_ROW_t keys[KEY_MATRIX_ROWS];
+
+//Was ghosting seen on the last scan?
+static volatile bool isGhosted = false;
+
+//Statistics
+static volatile KEY_MATRIX_STATS_t stats;
+
+//Returns true if more than 1 bit is set
+static inline bool KeyMatrix_hasMultipleBits(KEY_MATRIX_ROW_t bits)
+{
+    return ((bits & (bits - 1)) != 0);
+}
+
+//Read all columns (pressed = 1)
+static inline KEY_MATRIX_ROW_t KeyMatrix_readColumns(void)
+{
+    uint8_t low = (uint8_t)(~KEY_MATRIX_COL_LOW_VPORT.IN) & KEY_MATRIX_COL_LOW_MASK;
+    uint8_t high = (uint8_t)(~KEY_MATRIX_COL_HIGH_VPORT.IN) & KEY_MATRIX_COL_HIGH_MASK;
+    
+    return (((KEY_MATRIX_ROW_t) high) << 8) | low;
+}
+
+//Setup the row and column pins
+void KeyMatrix_Initialize(void)
+{
+    for (uint8_t i = 0; i < KEY_MATRIX_ROWS; i++)
+    {
+        keys[i] = 0;
+    }
+    
+    //Rows are inputs until selected, and drive low when selected
+    KEY_MATRIX_ROW_VPORT.DIR &= ~KEY_MATRIX_ROW_MASK;
+    KEY_MATRIX_ROW_VPORT.OUT &= ~KEY_MATRIX_ROW_MASK;
+    
+    //Columns are inputs with pull-ups
+    KEY_MATRIX_COL_LOW_VPORT.DIR &= ~KEY_MATRIX_COL_LOW_MASK;
+    KEY_MATRIX_COL_LOW_PORT.PINCONFIG = PORT_PULLUPEN_bm;
+    KEY_MATRIX_COL_LOW_PORT.PINCTRLUPD = KEY_MATRIX_COL_LOW_MASK;
+    
+    KEY_MATRIX_COL_HIGH_VPORT.DIR &= ~KEY_MATRIX_COL_HIGH_MASK;
+    KEY_MATRIX_COL_HIGH_PORT.PINCONFIG = PORT_PULLUPEN_bm;
+    KEY_MATRIX_COL_HIGH_PORT.PINCTRLUPD = KEY_MATRIX_COL_HIGH_MASK;
+    
+    isGhosted = false;
+}
+
+//Scan all rows - returns true if a key changed
+bool KeyMatrix_Scan(void)
+{
+    KEY_MATRIX_ROW_t sample[KEY_MATRIX_ROWS];
+    bool isChanged = false;
+    bool hasGhost = false;
+    
+    //Drive each row low in turn and read the columns
+    for (uint8_t row = 0; row < KEY_MATRIX_ROWS; row++)
+    {
+        KEY_MATRIX_ROW_VPORT.DIR |= rowPins[row];
+        _delay_us(KEY_MATRIX_SETTLE_US);
+        sample[row] = KeyMatrix_readColumns();
+        KEY_MATRIX_ROW_VPORT.DIR &= ~rowPins[row];
+    }
+    
+    //Ghost detection - if 2 rows share 2 or more columns, a 4th key in the rectangle
+    //cannot be told apart from a ghost without diodes
+    for (uint8_t i = 0; i < KEY_MATRIX_ROWS; i++)
+    {
+        for (uint8_t j = i + 1; j < KEY_MATRIX_ROWS; j++)
+        {
+            if (KeyMatrix_hasMultipleBits(sample[i] & sample[j]))
+            {
+                hasGhost = true;
+                
+#ifdef KEY_MATRIX_NO_DIODES
+                //Allow releases, block new presses in the ambiguous rows
+                sample[i] &= keys[i];
+                sample[j] &= keys[j];
+#endif
+            }
+        }
+    }
+    
+    for (uint8_t row = 0; row < KEY_MATRIX_ROWS; row++)
+    {
+        if (sample[row] != keys[row])
+        {
+            keys[row] = sample[row];
+            isChanged = true;
+        }
+    }
+    
+    isGhosted = hasGhost;
+    
+    stats.scans++;
+    if (hasGhost)
+    {
+        stats.ghostScans++;
+    }
+    
+    return isChanged;
+}
+
+//Returns the keys pressed in row
+KEY_MATRIX_ROW_t KeyMatrix_GetRow(uint8_t row)
+{
+    KEY_MATRIX_ROW_t value;
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        value = keys[row];
+    }
+    
+    return value;
+}
+
+//Returns true if the key at row, col is pressed
+bool KeyMatrix_IsPressed(uint8_t row, uint8_t col)
+{
+    return ((KeyMatrix_GetRow(row) & (((KEY_MATRIX_ROW_t) 1) << col)) != 0);
+}
+
+//Returns true if no keys are pressed
+bool KeyMatrix_IsIdle(void)
+{
+    for (uint8_t row = 0; row < KEY_MATRIX_ROWS; row++)
+    {
+        if (KeyMatrix_GetRow(row) != 0)
+        {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+//Finds the first pressed key - returns false if no keys are pressed
+bool KeyMatrix_GetFirstPressed(uint8_t* row, uint8_t* col)
+{
+    for (uint8_t r = 0; r < KEY_MATRIX_ROWS; r++)
+    {
+        KEY_MATRIX_ROW_t bits = KeyMatrix_GetRow(r);
+        
+        if (bits == 0)
+        {
+            continue;
+        }
+        
+        for (uint8_t c = 0; c < KEY_MATRIX_COLS; c++)
+        {
+            if (bits & (((KEY_MATRIX_ROW_t) 1) << c))
+            {
+                *row = r;
+                *col = c;
+                return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+//Returns true if ghosting was detected on the last scan
+bool KeyMatrix_HasGhost(void)
+{
+    return isGhosted;
+}
+
+//Copy and clear the scan statistics
+void KeyMatrix_GetStats(KEY_MATRIX_STATS_t* copy)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *copy = stats;
+        
+        stats.scans = 0;
+        stats.ghostScans = 0;
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef KEYMATRIX_H
+#define	KEYMATRIX_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+    //Number of rows (up to 8, all on the row port)
+#define KEY_MATRIX_ROWS 3
+    
+    //Number of columns (bit positions in a row - low port is bits 0-7, high port is bits 8-15)
+#define KEY_MATRIX_COLS 7
+    
+    //Row outputs - the selected row is driven low, the others are left floating
+    //KEY_MATRIX_ROW_MASK must hold all of the row pins
+#define KEY_MATRIX_ROW_VPORT VPORTF
+#define KEY_MATRIX_ROW_PINS { PIN0_bm, PIN1_bm, PIN3_bm }
+#define KEY_MATRIX_ROW_MASK (PIN0_bm | PIN1_bm | PIN3_bm)
+    
+    //Column inputs (pulled up, read low through the diode when a key is pressed)
+    //Set a mask to 0x00 if the port is not used
+#define KEY_MATRIX_COL_LOW_PORT PORTA
+#define KEY_MATRIX_COL_LOW_VPORT VPORTA
+#define KEY_MATRIX_COL_LOW_MASK 0x7F
+    
+#define KEY_MATRIX_COL_HIGH_PORT PORTD
+#define KEY_MATRIX_COL_HIGH_VPORT VPORTD
+#define KEY_MATRIX_COL_HIGH_MASK 0x00
+    
+    //Pins the board already uses on the row and column ports - change these with the ports
+    //PF2 LED0, PF4 Button 2, PF5 Interrupt, PF6 SW0, PF7 UPDI
+#define KEY_MATRIX_ROW_BOARD_PINS (PIN2_bm | PIN4_bm | PIN5_bm | PIN6_bm | PIN7_bm)
+    
+    //PA7 Button 3
+#define KEY_MATRIX_COL_LOW_BOARD_PINS (PIN7_bm)
+    
+    //PD1 and PD3 analog keys, PD2 Button 4, PD4 External Button, PD5 Button 1, PD6/PD7 UART
+#define KEY_MATRIX_COL_HIGH_BOARD_PINS (PIN1_bm | PIN2_bm | PIN3_bm | PIN4_bm | PIN5_bm | PIN6_bm | PIN7_bm)
+    
+    //Time for the columns to settle after a row is selected
+#define KEY_MATRIX_SETTLE_US 2
+    
+    //If set, the matrix has no diodes and key presses that could be ghosts are blocked
+    //With diodes, ghosting is only counted (a rectangle of keys points to a failed diode)
+    //#define KEY_MATRIX_NO_DIODES
+    
+    //One row of keys (bit n = column n)
+    typedef uint16_t KEY_MATRIX_ROW_t;
+    
+    //Scan statistics
+    typedef struct {
+        //Number of scans
+        uint16_t scans;
+        
+        //Scans where ghosting was detected
+        uint16_t ghostScans;
+    } KEY_MATRIX_STATS_t;
+    
+    //Setup the row and column pins
+    void KeyMatrix_Initialize(void);
+    
+    //Scan all rows - returns true if a key changed
+    bool KeyMatrix_Scan(void);
+    
+    //Returns the keys pressed in row
+    KEY_MATRIX_ROW_t KeyMatrix_GetRow(uint8_t row);
+    
+    //Returns true if the key at row, col is pressed
+    bool KeyMatrix_IsPressed(uint8_t row, uint8_t col);
+    
+    //Returns true if no keys are pressed
+    bool KeyMatrix_IsIdle(void);
+    
+    //Finds the first pressed key - returns false if no keys are pressed
+    bool KeyMatrix_GetFirstPressed(uint8_t* row, uint8_t* col);
+    
+    //Returns true if ghosting was detected on the last scan
+    bool KeyMatrix_HasGhost(void);
+    
+    //Copy and clear the scan statistics
+    void KeyMatrix_GetStats(KEY_MATRIX_STATS_t* stats);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* KEYMATRIX_H */
@@ -0,0 +1,127 @@
+#include "KeySampleQueue.h"
+
+#include <string.h>
+#include <util/atomic.h>
+
+#include "mcc_generated_files/usb/usb_hid/usb_hid_keycodes.h"
+#include "Timebase.h"
+
+#if (KEY_SAMPLE_QUEUE_SIZE & (KEY_SAMPLE_QUEUE_SIZE - 1)) || (KEY_SAMPLE_QUEUE_SIZE < 2) || (KEY_SAMPLE_QUEUE_SIZE > 128)
+#error "KEY_SAMPLE_QUEUE_SIZE must be a power of 2, from 2 to 128"
+#endif
+
+//Indexes run freely and are masked on use, so a full queue is head - tail == size
+#define KEY_SAMPLE_QUEUE_MASK (KEY_SAMPLE_QUEUE_SIZE - 1)
+
+//Samples
+static volatile KEY_SAMPLE_t samples[KEY_SAMPLE_QUEUE_SIZE];
+
+//Next sample to write - only changed by the producer
+static volatile uint8_t head = 0;
+
+//Next sample to read - only changed by the consumer
+static volatile uint8_t tail = 0;
+
+//Statistics
+static volatile KEY_SAMPLE_QUEUE_STATS_t stats;
+
+//Empty the queue
+void KeySampleQueue_Initialize(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        head = 0;
+        tail = 0;
+        
+        stats.maxDepth = 0;
+        stats.mergedCount = 0;
+        stats.maxDelay = 0;
+    }
+}
+
+//Producer - Add a sample
+bool KeySampleQueue_Push(const KEY_SAMPLE_t* sample)
+{
+    //Single byte reads and writes are atomic on AVR
+    uint8_t index = head;
+    uint8_t depth = (uint8_t)(index - tail);
+    
+    if (depth >= KEY_SAMPLE_QUEUE_SIZE)
+    {
+        //Merge into the newest sample - with 2 or more slots, the consumer is never reading it
+        volatile KEY_SAMPLE_t* newest = &samples[(uint8_t)(index - 1) & KEY_SAMPLE_QUEUE_MASK];
+        
+        //Keep the presses of both, and the time and source of the first
+        newest->keys |= sample->keys;
+        if (newest->matrixKey == HID_KEY_NONE)
+        {
+            newest->matrixKey = sample->matrixKey;
+        }
+        newest->isMatrixIdle = ((newest->isMatrixIdle) && (sample->isMatrixIdle));
+        
+        stats.mergedCount++;
+        return false;
+    }
+    
+    memcpy((void*) &samples[index & KEY_SAMPLE_QUEUE_MASK], sample, sizeof(KEY_SAMPLE_t));
+    
+    if (depth >= stats.maxDepth)
+    {
+        stats.maxDepth = depth + 1;
+    }
+    
+    //Publish the sample last - the consumer can read it from here on
+    head = index + 1;
+    
+    return true;
+}
+
+//Consumer - Returns true if there are no samples
+bool KeySampleQueue_IsEmpty(void)
+{
+    return (head == tail);
+}
+
+//Consumer - Remove the oldest sample
+bool KeySampleQueue_Pop(KEY_SAMPLE_t* sample)
+{
+    uint8_t index = tail;
+    
+    if (head == index)
+    {
+        return false;
+    }
+    
+    memcpy(sample, (const void*) &samples[index & KEY_SAMPLE_QUEUE_MASK], sizeof(KEY_SAMPLE_t));
+    
+    //Free the slot only after it has been copied
+    tail = index + 1;
+    
+    //Only the consumer writes maxDelay
+    uint32_t delay = Timebase_Elapsed(sample->time);
+    if (delay > stats.maxDelay)
+    {
+        stats.maxDelay = (delay > UINT16_MAX) ? UINT16_MAX : delay;
+    }
+    
+    return true;
+}
+
+//Consumer - Discard all samples
+void KeySampleQueue_Clear(void)
+{
+    tail = head;
+}
+
+//Copy and clear the statistics
+void KeySampleQueue_GetStats(KEY_SAMPLE_QUEUE_STATS_t* copy)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *copy = stats;
+        
+        stats.maxDepth = 0;
+        stats.mergedCount = 0;
+        stats.maxDelay = 0;
+    }
+}
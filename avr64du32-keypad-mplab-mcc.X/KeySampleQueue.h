@@ -0,0 +1,73 @@
+#ifndef KEYSAMPLEQUEUE_H
+#define	KEYSAMPLEQUEUE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+#include "KeyEngine.h"
+#include "ScanLatency.h"
+    
+    //Number of samples in the queue (power of 2, from 2 to 128)
+#define KEY_SAMPLE_QUEUE_SIZE 4
+    
+    //Keys sampled by the scan interrupt
+    typedef struct {
+        //Time (us) of the sample
+        uint32_t time;
+    
+        //What triggered the scan
+        SCAN_LATENCY_SOURCE source;
+    
+        //Debounced keymap keys
+        KEY_ENGINE_KEYS_t keys;
+    
+        //Key matrix - HID key of the first key pressed (HID_KEY_NONE if none), and is the matrix released?
+        uint8_t matrixKey;
+        bool isMatrixIdle;
+    } KEY_SAMPLE_t;
+    
+    //Queue statistics
+    typedef struct {
+        //Most samples in the queue at once
+        uint8_t maxDepth;
+    
+        //Samples merged into the newest one because the queue was full
+        uint16_t mergedCount;
+    
+        //Worst time (us) from sample to pop
+        uint16_t maxDelay;
+    } KEY_SAMPLE_QUEUE_STATS_t;
+    
+    //The queue has one producer (the key scan ISR) and one consumer (the key task)
+    //Neither side disables interrupts to pass samples - each side only writes its own index
+    
+    //Empty the queue
+    void KeySampleQueue_Initialize(void);
+    
+    //Producer - Add a sample
+    //If the queue is full, the sample is merged into the newest one: the keys pressed in either are kept,
+    //so no press is lost, and a release arrives with the next sample. Returns false if the sample was merged
+    bool KeySampleQueue_Push(const KEY_SAMPLE_t* sample);
+    
+    //Consumer - Returns true if there are no samples
+    bool KeySampleQueue_IsEmpty(void);
+    
+    //Consumer - Remove the oldest sample
+    //Returns false if the queue is empty
+    bool KeySampleQueue_Pop(KEY_SAMPLE_t* sample);
+    
+    //Consumer - Discard all samples (e.g. when VBUS is removed)
+    void KeySampleQueue_Clear(void);
+    
+    //Copy and clear the statistics
+    void KeySampleQueue_GetStats(KEY_SAMPLE_QUEUE_STATS_t* stats);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* KEYSAMPLEQUEUE_H */
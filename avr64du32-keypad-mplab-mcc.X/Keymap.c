@@ -0,0 +1,568 @@
+#include "Keymap.h"
+
+#include <avr/eeprom.h>
+#include <stddef.h>
+#include <util/atomic.h>
+
+#include "mcc_generated_files/usb/usb_hid/usb_hid_keycodes.h"
+#include "KeyReporting.h"
+
+#if KEYMAP_ENTRIES > 16
+#error "The pending change mask holds up to 16 entries"
+#endif
+
+//Keymap as stored in EEPROM
+//journalStart is the first journal record for this copy - the journal moves on at each fold
+typedef struct {
+    uint8_t sequence;
+    uint8_t version;
+    uint8_t journalStart;
+    KEYMAP_ACTION_t actions[KEYMAP_ENTRIES];
+    uint8_t checksum;
+} KEYMAP_EEPROM_t;
+
+//Change in the journal - the sequence is written last, and marks the record as complete
+//Records of older copies keep their old sequence, so they are never erased
+typedef struct {
+    uint8_t entry;
+    KEYMAP_ACTION_t action;
+    uint8_t sequence;
+} KEYMAP_JOURNAL_RECORD_t;
+
+//Value of erased EEPROM (never used as a sequence)
+#define KEYMAP_ERASED 0xFF
+
+typedef enum {
+    KEYMAP_STORE_IDLE = 0, KEYMAP_STORE_APPEND, KEYMAP_STORE_COMPACT
+} KEYMAP_STORE_STATE;
+
+//Text typed by KEYMAP_ACTION_TEXT keys
+static const char* const keymapText[] = 
+{
+    "AVR DU"
+};
+
+#define KEYMAP_TEXT_COUNT (sizeof(keymapText) / sizeof(keymapText[0]))
+
+//Default keymap for the base layer (the other layers default to transparent)
+static const KEYMAP_ACTION_t defaultKeymap[KEYMAP_KEYS] = 
+{
+    //SW0 - Print "AVR DU"
+    [KEYMAP_SW0] = { KEYMAP_ACTION_TEXT, HID_MODIFIER_NONE, 0 },
+    
+    //External Button - Send ALT + F4
+    [KEYMAP_EXTERNAL] = { KEYMAP_ACTION_KEY, HID_MODIFIER_LEFT_ALT, HID_F4 },
+    
+    //BUTTON1 - CTRL + C
+    [KEYMAP_COPY_BUTTON] = { KEYMAP_ACTION_KEY, HID_MODIFIER_LEFT_CTRL, HID_C },
+    
+    //BUTTON2 - CTRL + V
+    [KEYMAP_PASTE_BUTTON] = { KEYMAP_ACTION_KEY, HID_MODIFIER_LEFT_CTRL, HID_V },
+    
+    //BUTTON3 - CTRL + Z
+    [KEYMAP_UNDO_BUTTON] = { KEYMAP_ACTION_KEY, HID_MODIFIER_LEFT_CTRL, HID_Z },
+    
+    //BUTTON4 - CTRL + X
+    [KEYMAP_CUT_BUTTON] = { KEYMAP_ACTION_KEY, HID_MODIFIER_LEFT_CTRL, HID_X },
+    
+    //Analog Keys - Z and X (others do nothing)
+#if ANALOG_KEYS_COUNT >= 1
+    [KEYMAP_ANALOG_FIRST] = { KEYMAP_ACTION_KEY, HID_MODIFIER_NONE, HID_Z },
+#endif
+#if ANALOG_KEYS_COUNT >= 2
+    [KEYMAP_ANALOG_FIRST + 1] = { KEYMAP_ACTION_KEY, HID_MODIFIER_NONE, HID_X },
+#endif
+};
+
+//Two copies of the keymap in EEPROM - the valid copy with the newest sequence is used
+static KEYMAP_EEPROM_t EEMEM keymapEEPROM[2];
+
+//Changes since the keymap copy was written, in a ring
+static KEYMAP_JOURNAL_RECORD_t EEMEM keymapJournal[KEYMAP_JOURNAL_RECORDS];
+
+//Keymap in RAM, used by the scan
+static volatile KEYMAP_ACTION_t keymap[KEYMAP_ENTRIES];
+
+//Keymap copy in use, and its sequence
+static uint8_t activeCopy = 0;
+static uint8_t sequence = 0;
+
+//First journal record of the keymap copy in use, and the records used since
+static uint8_t journalStart = 0;
+static uint8_t journalCount = 0;
+
+//Entries changed since they were last written (bit n = entry n)
+static volatile uint16_t pendingKeys = 0;
+
+//Scan ticks until the pending changes are written
+static volatile uint8_t commitTicks = 0;
+static volatile bool isCommitDue = false;
+
+//EEPROM write in progress
+static KEYMAP_STORE_STATE storeState = KEYMAP_STORE_IDLE;
+static uint8_t writeBuffer[sizeof(KEYMAP_EEPROM_t)];
+static uint8_t* writeAddress = NULL;
+static uint8_t writeLength = 0;
+static uint8_t writeIndex = 0;
+
+//Statistics
+static volatile KEYMAP_STATS_t stats;
+
+//Checksum of a stored keymap
+static uint8_t Keymap_checksum(const KEYMAP_EEPROM_t* stored)
+{
+    const uint8_t* data = (const uint8_t*) stored;
+    uint8_t sum = 0;
+    
+    for (uint8_t i = 0; i < offsetof(KEYMAP_EEPROM_t, checksum); i++)
+    {
+        sum += data[i];
+    }
+    
+    return ~sum;
+}
+
+//Returns record n of a journal that starts at record start (the journal wraps around)
+static KEYMAP_JOURNAL_RECORD_t* Keymap_journalRecord(uint8_t start, uint8_t n)
+{
+    return &keymapJournal[(start + n) % KEYMAP_JOURNAL_RECORDS];
+}
+
+//Returns the sequence after seq (skips the erased value)
+static uint8_t Keymap_nextSequence(uint8_t seq)
+{
+    seq++;
+    if (seq == KEYMAP_ERASED)
+    {
+        seq = 0;
+    }
+    
+    return seq;
+}
+
+//Returns true if the action can be used
+static bool Keymap_isValid(KEYMAP_ACTION_t action)
+{
+    if (action.type >= KEYMAP_ACTION_COUNT)
+    {
+        return false;
+    }
+    
+    if ((action.type == KEYMAP_ACTION_TEXT) && (action.keycode >= KEYMAP_TEXT_COUNT))
+    {
+        return false;
+    }
+    
+    if ((action.type == KEYMAP_ACTION_TAP_LAYER) && (action.modifier >= KEYMAP_LAYERS))
+    {
+        return false;
+    }
+    
+    return true;
+}
+
+//Returns the default action of a keymap entry
+static KEYMAP_ACTION_t Keymap_default(uint8_t entry)
+{
+    KEYMAP_ACTION_t action = { KEYMAP_ACTION_TRANSPARENT, HID_MODIFIER_NONE, HID_KEY_NONE };
+    
+    if (entry < KEYMAP_KEYS)
+    {
+        action = defaultKeymap[entry];
+    }
+    
+    return action;
+}
+
+//Returns true if a stored keymap copy can be used
+static bool Keymap_isValidCopy(const KEYMAP_EEPROM_t* stored)
+{
+    return ((stored->version == KEYMAP_VERSION) && (stored->sequence != KEYMAP_ERASED)
+            && (stored->journalStart < KEYMAP_JOURNAL_RECORDS) && (stored->checksum == Keymap_checksum(stored)));
+}
+
+//Fill in a keymap copy from RAM
+static void Keymap_buildCopy(KEYMAP_EEPROM_t* stored, uint8_t seq, uint8_t start)
+{
+    stored->sequence = seq;
+    stored->version = KEYMAP_VERSION;
+    stored->journalStart = start;
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        for (uint8_t i = 0; i < KEYMAP_ENTRIES; i++)
+        {
+            stored->actions[i] = keymap[i];
+        }
+    }
+    
+    stored->checksum = Keymap_checksum(stored);
+}
+
+//Load the keymap and replay the journal from EEPROM into RAM
+void Keymap_Initialize(void)
+{
+    KEYMAP_EEPROM_t stored;
+    bool isFound = false;
+    
+    storeState = KEYMAP_STORE_IDLE;
+    pendingKeys = 0;
+    isCommitDue = false;
+    
+    //Find the newest valid copy
+    for (uint8_t copy = 0; copy < 2; copy++)
+    {
+        eeprom_read_block(&stored, &keymapEEPROM[copy], sizeof(stored));
+        
+        if (!Keymap_isValidCopy(&stored))
+        {
+            continue;
+        }
+        
+        if ((!isFound) || ((int8_t)(stored.sequence - sequence) > 0))
+        {
+            activeCopy = copy;
+            sequence = stored.sequence;
+            isFound = true;
+        }
+    }
+    
+    if (!isFound)
+    {
+        //Blank or from another layout - start again from the defaults
+        Keymap_LoadDefaults();
+        pendingKeys = 0;
+        
+        activeCopy = 0;
+        sequence = 0;
+        journalStart = 0;
+        journalCount = 0;
+        Keymap_buildCopy(&stored, sequence, journalStart);
+        eeprom_update_block(&stored, &keymapEEPROM[activeCopy], sizeof(stored));
+        
+        for (uint8_t i = 0; i < KEYMAP_JOURNAL_RECORDS; i++)
+        {
+            eeprom_update_byte(&keymapJournal[i].sequence, KEYMAP_ERASED);
+        }
+        return;
+    }
+    
+    eeprom_read_block(&stored, &keymapEEPROM[activeCopy], sizeof(stored));
+    journalStart = stored.journalStart;
+    
+    for (uint8_t i = 0; i < KEYMAP_ENTRIES; i++)
+    {
+        if (Keymap_isValid(stored.actions[i]))
+        {
+            keymap[i] = stored.actions[i];
+        }
+        else
+        {
+            keymap[i] = Keymap_default(i);
+        }
+    }
+    
+    //Replay the changes made since the copy was written, from the start of its journal
+    for (journalCount = 0; journalCount < KEYMAP_JOURNAL_RECORDS; journalCount++)
+    {
+        KEYMAP_JOURNAL_RECORD_t record;
+        
+        eeprom_read_block(&record, Keymap_journalRecord(journalStart, journalCount), sizeof(record));
+        
+        //End of the journal (or an unfinished record)
+        if (record.sequence != sequence)
+        {
+            break;
+        }
+        
+        if ((record.entry < KEYMAP_ENTRIES) && (Keymap_isValid(record.action)))
+        {
+            keymap[record.entry] = record.action;
+        }
+    }
+}
+
+//Returns the action of a keymap entry
+KEYMAP_ACTION_t Keymap_Get(uint8_t entry)
+{
+    KEYMAP_ACTION_t action = { KEYMAP_ACTION_NONE, HID_MODIFIER_NONE, HID_KEY_NONE };
+    
+    if (entry >= KEYMAP_ENTRIES)
+    {
+        return action;
+    }
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        action = keymap[entry];
+    }
+    
+    return action;
+}
+
+//Returns the action of a key on a layer
+KEYMAP_ACTION_t Keymap_Lookup(uint8_t layer, uint8_t key)
+{
+    KEYMAP_ACTION_t action = { KEYMAP_ACTION_NONE, HID_MODIFIER_NONE, HID_KEY_NONE };
+    
+    if ((key >= KEYMAP_KEYS) || (layer >= KEYMAP_LAYERS))
+    {
+        return action;
+    }
+    
+    //Direct lookup, falling through transparent entries
+    while (true)
+    {
+        action = keymap[(layer * KEYMAP_KEYS) + key];
+        
+        if ((action.type != KEYMAP_ACTION_TRANSPARENT) || (layer == 0))
+        {
+            break;
+        }
+        layer--;
+    }
+    
+    if (action.type == KEYMAP_ACTION_TRANSPARENT)
+    {
+        action.type = KEYMAP_ACTION_NONE;
+    }
+    
+    return action;
+}
+
+//Change the action of a keymap entry - takes effect at once, and is written to EEPROM later
+bool Keymap_Set(uint8_t entry, KEYMAP_ACTION_t action)
+{
+    if ((entry >= KEYMAP_ENTRIES) || (!Keymap_isValid(action)))
+    {
+        return false;
+    }
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        keymap[entry] = action;
+        
+        //Batch changes until they stop for a while
+        pendingKeys |= (1 << entry);
+        commitTicks = KEYMAP_COMMIT_DELAY;
+        isCommitDue = false;
+    }
+    
+    return true;
+}
+
+//Restore the default keymap (written to EEPROM later)
+void Keymap_LoadDefaults(void)
+{
+    for (uint8_t i = 0; i < KEYMAP_ENTRIES; i++)
+    {
+        Keymap_Set(i, Keymap_default(i));
+    }
+}
+
+//Write the pending changes to EEPROM without waiting for KEYMAP_COMMIT_DELAY
+void Keymap_Commit(void)
+{
+    isCommitDue = true;
+}
+
+//Count down to the next commit - call every scan
+void Keymap_Tick(void)
+{
+    if ((pendingKeys == 0) || (isCommitDue))
+    {
+        return;
+    }
+    
+    if (commitTicks > 0)
+    {
+        commitTicks--;
+    }
+    else
+    {
+        isCommitDue = true;
+    }
+}
+
+//Start writing the next change
+static void Keymap_startWrite(void)
+{
+    if (journalCount >= KEYMAP_JOURNAL_RECORDS)
+    {
+        //Journal is full - fold everything into the other keymap copy
+        //The new copy starts its journal after the last record, so the records are written in turn
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            pendingKeys = 0;
+        }
+        
+        Keymap_buildCopy((KEYMAP_EEPROM_t*) writeBuffer, Keymap_nextSequence(sequence), 
+                (journalStart + journalCount) % KEYMAP_JOURNAL_RECORDS);
+        writeAddress = (uint8_t*) &keymapEEPROM[activeCopy ^ 1];
+        writeLength = sizeof(KEYMAP_EEPROM_t);
+        storeState = KEYMAP_STORE_COMPACT;
+    }
+    else
+    {
+        //Append the lowest changed entry to the journal
+        KEYMAP_JOURNAL_RECORD_t* record = (KEYMAP_JOURNAL_RECORD_t*) writeBuffer;
+        uint8_t entry = 0;
+        
+        while (!(pendingKeys & (1 << entry)))
+        {
+            entry++;
+        }
+        
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            pendingKeys &= ~(1 << entry);
+            record->action = keymap[entry];
+        }
+        record->entry = entry;
+        record->sequence = sequence;
+        
+        writeAddress = (uint8_t*) Keymap_journalRecord(journalStart, journalCount);
+        writeLength = sizeof(KEYMAP_JOURNAL_RECORD_t);
+        storeState = KEYMAP_STORE_APPEND;
+    }
+    
+    writeIndex = 0;
+}
+
+//Finish the write in progress
+static void Keymap_finishWrite(void)
+{
+    switch (storeState)
+    {
+        case KEYMAP_STORE_APPEND:
+        {
+            journalCount++;
+            stats.journalWrites++;
+            storeState = KEYMAP_STORE_IDLE;
+            break;
+        }
+        case KEYMAP_STORE_COMPACT:
+        {
+            //The new copy is complete - the old journal no longer applies
+            //Its records keep the old sequence, so they end the replay of the new journal
+            activeCopy ^= 1;
+            sequence = Keymap_nextSequence(sequence);
+            journalStart = ((KEYMAP_EEPROM_t*) writeBuffer)->journalStart;
+            journalCount = 0;
+            stats.compactions++;
+            
+            storeState = KEYMAP_STORE_IDLE;
+            break;
+        }
+        default:
+        {
+            storeState = KEYMAP_STORE_IDLE;
+        }
+    }
+    
+    if ((storeState == KEYMAP_STORE_IDLE) && (pendingKeys == 0))
+    {
+        isCommitDue = false;
+    }
+}
+
+//Write pending changes to EEPROM, one byte at a time
+bool Keymap_Service(void)
+{
+    //Don't wait for the EEPROM
+    if (!eeprom_is_ready())
+    {
+        return true;
+    }
+    
+    if (storeState == KEYMAP_STORE_IDLE)
+    {
+        if ((!isCommitDue) || (pendingKeys == 0))
+        {
+            return false;
+        }
+        
+        Keymap_startWrite();
+    }
+    
+    //Only bytes that changed are written
+    eeprom_update_byte(writeAddress + writeIndex, writeBuffer[writeIndex]);
+    writeIndex++;
+    
+    if (writeIndex < writeLength)
+    {
+        return true;
+    }
+    
+    Keymap_finishWrite();
+    
+    return ((storeState != KEYMAP_STORE_IDLE) || ((isCommitDue) && (pendingKeys != 0)));
+}
+
+//Returns true while changes are waiting to be written to EEPROM
+bool Keymap_IsBusy(void)
+{
+    return ((pendingKeys != 0) || (storeState != KEYMAP_STORE_IDLE));
+}
+
+//Returns the number of keys with changes waiting to be written
+uint8_t Keymap_GetPendingCount(void)
+{
+    uint16_t keys = pendingKeys;
+    uint8_t count = 0;
+    
+    while (keys)
+    {
+        keys &= (keys - 1);
+        count++;
+    }
+    
+    return count;
+}
+
+//Copy and clear the storage statistics
+void Keymap_GetStats(KEYMAP_STATS_t* copy)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *copy = stats;
+        
+        stats.journalWrites = 0;
+        stats.compactions = 0;
+    }
+}
+
+//Add the key down events of an action to keyReport
+bool Keymap_Apply(KEYMAP_ACTION_t action, USB_KEYBOARD_REPORT_DATA_t* keyReport)
+{
+    switch (action.type)
+    {
+        case KEYMAP_ACTION_KEY:
+        {
+            KeyReport_addKeyDownEvent(keyReport, action.modifier, action.keycode);
+            return true;
+        }
+        case KEYMAP_ACTION_TEXT:
+        {
+            const char* text = keymapText[action.keycode];
+            
+            while (*text != '\0')
+            {
+                KeyReport_addKeyDownEventFromChar(keyReport, *text);
+                text++;
+            }
+            return true;
+        }
+        case KEYMAP_ACTION_TAP_HOLD:
+        case KEYMAP_ACTION_TAP_LAYER:
+        {
+            //Tap key only - the hold part is handled by the key engine
+            KeyReport_addKeyDownEvent(keyReport, HID_MODIFIER_NONE, action.keycode);
+            return true;
+        }
+        default:
+        {
+            return false;
+        }
+    }
+}
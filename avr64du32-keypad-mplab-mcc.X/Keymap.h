@@ -0,0 +1,122 @@
+#ifndef KEYMAP_H
+#define	KEYMAP_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+#include "mcc_generated_files/usb/usb_hid/usb_protocol_hid.h"
+#include "ButtonScan.h"
+#include "AnalogKeys.h"
+    
+    //Key index of the buttons (same as the bit in the button bitmap)
+#define KEYMAP_SW0 BUTTON_SCAN_SW0_bp
+#define KEYMAP_EXTERNAL BUTTON_SCAN_EXTERNAL_bp
+#define KEYMAP_BUTTON1 BUTTON_SCAN_BUTTON1_bp
+#define KEYMAP_BUTTON2 BUTTON_SCAN_BUTTON2_bp
+#define KEYMAP_BUTTON3 BUTTON_SCAN_BUTTON3_bp
+#define KEYMAP_BUTTON4 BUTTON_SCAN_BUTTON4_bp
+    
+#define KEYMAP_COPY_BUTTON KEYMAP_BUTTON1
+#define KEYMAP_PASTE_BUTTON KEYMAP_BUTTON2
+#define KEYMAP_UNDO_BUTTON KEYMAP_BUTTON3
+#define KEYMAP_CUT_BUTTON KEYMAP_BUTTON4
+    
+    //Key index of the first analog key
+#define KEYMAP_ANALOG_FIRST BUTTON_SCAN_COUNT
+    
+    //Number of keys in the keymap
+#define KEYMAP_KEYS (BUTTON_SCAN_COUNT + ANALOG_KEYS_COUNT)
+    
+    //Number of layers (layer 0 is the base layer)
+#define KEYMAP_LAYERS 2
+    
+    //Number of entries in the keymap - entry = (layer * KEYMAP_KEYS) + key
+#define KEYMAP_ENTRIES (KEYMAP_LAYERS * KEYMAP_KEYS)
+    
+    //Layout version of the keymap in EEPROM - change to reload the defaults
+#define KEYMAP_VERSION 0x04
+    
+    //Number of changes the EEPROM journal holds before it is folded into the keymap
+    //The rest of the 256 byte EEPROM holds the macro (see Macro.h)
+#define KEYMAP_JOURNAL_RECORDS 8
+    
+    //Scan ticks without a change before changes are written to EEPROM
+#define KEYMAP_COMMIT_DELAY 100
+    
+    //What a key does
+    typedef enum {
+        KEYMAP_ACTION_NONE = 0, KEYMAP_ACTION_KEY, KEYMAP_ACTION_TEXT, KEYMAP_ACTION_TRANSPARENT, 
+        KEYMAP_ACTION_TAP_HOLD, KEYMAP_ACTION_TAP_LAYER, KEYMAP_ACTION_MACRO_RECORD, KEYMAP_ACTION_MACRO_PLAY,
+        KEYMAP_ACTION_COUNT
+    } KEYMAP_ACTION_TYPE;
+    
+    //Packed keymap entry
+    //For KEYMAP_ACTION_TEXT, keycode is the index of the text to type
+    //For KEYMAP_ACTION_TRANSPARENT, the key uses the action of the layer below
+    //For KEYMAP_ACTION_TAP_HOLD, a tap sends keycode, a hold holds the modifier
+    //For KEYMAP_ACTION_TAP_LAYER, a tap sends keycode, a hold shifts to the layer in modifier
+    //For KEYMAP_ACTION_MACRO_RECORD, a press starts or stops recording the macro
+    //For KEYMAP_ACTION_MACRO_PLAY, a press plays the macro
+    typedef struct {
+        uint8_t type;
+        uint8_t modifier;
+        uint8_t keycode;
+    } KEYMAP_ACTION_t;
+    
+    //Keymap storage statistics
+    typedef struct {
+        //Changes written to the journal
+        uint16_t journalWrites;
+        
+        //Journal folds into the keymap
+        uint16_t compactions;
+    } KEYMAP_STATS_t;
+    
+    //Load the keymap and replay the journal from EEPROM into RAM (or the defaults, if EEPROM is blank or invalid)
+    void Keymap_Initialize(void);
+    
+    //Returns the action of a keymap entry
+    KEYMAP_ACTION_t Keymap_Get(uint8_t entry);
+    
+    //Returns the action of a key on a layer (transparent entries use the layer below)
+    KEYMAP_ACTION_t Keymap_Lookup(uint8_t layer, uint8_t key);
+    
+    //Change the action of a keymap entry - takes effect at once, and is written to EEPROM later
+    //Returns false if the entry or action is invalid
+    bool Keymap_Set(uint8_t entry, KEYMAP_ACTION_t action);
+    
+    //Restore the default keymap (written to EEPROM later)
+    void Keymap_LoadDefaults(void);
+    
+    //Write the pending changes to EEPROM without waiting for KEYMAP_COMMIT_DELAY
+    void Keymap_Commit(void);
+    
+    //Count down to the next commit - call every scan
+    void Keymap_Tick(void);
+    
+    //Write pending changes to EEPROM, one byte at a time - call from the main loop
+    //Returns true while a write is in progress (call again without sleeping)
+    bool Keymap_Service(void);
+    
+    //Returns true while changes are waiting to be written to EEPROM
+    bool Keymap_IsBusy(void);
+    
+    //Returns the number of keys with changes waiting to be written
+    uint8_t Keymap_GetPendingCount(void);
+    
+    //Copy and clear the storage statistics
+    void Keymap_GetStats(KEYMAP_STATS_t* stats);
+    
+    //Add the key down events of an action to keyReport (dual-role actions add their tap key)
+    //Returns false if the action does nothing
+    bool Keymap_Apply(KEYMAP_ACTION_t action, USB_KEYBOARD_REPORT_DATA_t* keyReport);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* KEYMAP_H */
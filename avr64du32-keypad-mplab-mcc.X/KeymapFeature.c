@@ -0,0 +1,186 @@
+#include "KeymapFeature.h"
+
+#include <stdbool.h>
+
+#include "usb_config.h"
+#include "usb_hid.h"
+#include "Keymap.h"
+#include "PinCapture.h"
+
+//Number of entries in a report (leaves 2 bytes for the pending count and status)
+#define KEYMAP_FEATURE_ENTRIES ((USB_HID_FEATURE_REPORT_SIZE - KEYMAP_FEATURE_ENTRY_OFFSET - 2) / KEYMAP_FEATURE_ENTRY_SIZE)
+
+//First key returned by GET_REPORT
+static uint8_t selectedKey = 0;
+
+//Is GET_REPORT returning captured samples? (From selectedSample)
+static bool isCaptureSelected = false;
+static uint8_t selectedSample = 0;
+
+//Status of the last command
+static uint8_t lastStatus = KEYMAP_FEATURE_STATUS_OK;
+
+//Apply the entries of a write command
+static bool KeymapFeature_write(uint8_t* data, uint16_t length)
+{
+    uint8_t count = data[1];
+    bool isOK = true;
+    
+    if ((count > KEYMAP_FEATURE_ENTRIES) 
+            || (length < (KEYMAP_FEATURE_ENTRY_OFFSET + (count * KEYMAP_FEATURE_ENTRY_SIZE))))
+    {
+        return false;
+    }
+    
+    data += KEYMAP_FEATURE_ENTRY_OFFSET;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        KEYMAP_ACTION_t action = { data[1], data[2], data[3] };
+        
+        //Keep going - report the error after the valid entries are applied
+        if (!Keymap_Set(data[0], action))
+        {
+            isOK = false;
+        }
+        
+        data += KEYMAP_FEATURE_ENTRY_SIZE;
+    }
+    
+    return isOK;
+}
+
+//Start or stop a pin capture
+static bool KeymapFeature_capture(uint8_t mode)
+{
+    switch (mode)
+    {
+        case KEYMAP_FEATURE_CAPTURE_STOP:
+        {
+            PinCapture_Stop();
+            break;
+        }
+        case KEYMAP_FEATURE_CAPTURE_SCAN:
+        {
+            PinCapture_StartScan();
+            break;
+        }
+        case KEYMAP_FEATURE_CAPTURE_BURST:
+        {
+            PinCapture_StartBurst();
+            break;
+        }
+        default:
+        {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+//SET_REPORT - run a command
+static void KeymapFeature_onSet(uint8_t* data, uint16_t length)
+{
+    bool isOK = true;
+    
+    if (length < 2)
+    {
+        lastStatus = KEYMAP_FEATURE_STATUS_ERROR;
+        return;
+    }
+    
+    switch (data[0])
+    {
+        case KEYMAP_FEATURE_SELECT:
+        {
+            selectedKey = data[1];
+            isCaptureSelected = false;
+            isOK = (selectedKey < KEYMAP_ENTRIES);
+            break;
+        }
+        case KEYMAP_FEATURE_WRITE:
+        {
+            isOK = KeymapFeature_write(data, length);
+            break;
+        }
+        case KEYMAP_FEATURE_COMMIT:
+        {
+            Keymap_Commit();
+            break;
+        }
+        case KEYMAP_FEATURE_DEFAULTS:
+        {
+            Keymap_LoadDefaults();
+            break;
+        }
+        case KEYMAP_FEATURE_CAPTURE:
+        {
+            isOK = KeymapFeature_capture(data[1]);
+            break;
+        }
+        case KEYMAP_FEATURE_CAPTURE_READ:
+        {
+            selectedSample = data[1];
+            isCaptureSelected = true;
+            break;
+        }
+        default:
+        {
+            isOK = false;
+        }
+    }
+    
+    lastStatus = (isOK) ? KEYMAP_FEATURE_STATUS_OK : KEYMAP_FEATURE_STATUS_ERROR;
+}
+
+//GET_REPORT - return the keymap from the selected key, or the captured samples
+static uint16_t KeymapFeature_onGet(uint8_t* data, uint16_t maxLength)
+{
+    uint8_t count = 0;
+    uint8_t* entry = &data[KEYMAP_FEATURE_ENTRY_OFFSET];
+    
+    for (uint16_t i = 0; i < maxLength; i++)
+    {
+        data[i] = 0;
+    }
+    
+    if (isCaptureSelected)
+    {
+        data[0] = PinCapture_GetState();
+        data[1] = PinCapture_Read(selectedSample, entry, USB_HID_FEATURE_REPORT_SIZE - KEYMAP_FEATURE_ENTRY_OFFSET - 2);
+        data[USB_HID_FEATURE_REPORT_SIZE - 2] = PinCapture_GetCount();
+        data[USB_HID_FEATURE_REPORT_SIZE - 1] = lastStatus;
+        
+        return USB_HID_FEATURE_REPORT_SIZE;
+    }
+    
+    for (uint8_t key = selectedKey; (key < KEYMAP_ENTRIES) && (count < KEYMAP_FEATURE_ENTRIES); key++)
+    {
+        KEYMAP_ACTION_t action = Keymap_Get(key);
+        
+        entry[0] = key;
+        entry[1] = action.type;
+        entry[2] = action.modifier;
+        entry[3] = action.keycode;
+        
+        entry += KEYMAP_FEATURE_ENTRY_SIZE;
+        count++;
+    }
+    
+    data[0] = KEYMAP_ENTRIES;
+    data[1] = count;
+    data[USB_HID_FEATURE_REPORT_SIZE - 2] = Keymap_GetPendingCount();
+    data[USB_HID_FEATURE_REPORT_SIZE - 1] = lastStatus;
+    
+    return USB_HID_FEATURE_REPORT_SIZE;
+}
+
+//Handle the keymap feature report
+void KeymapFeature_Initialize(void)
+{
+    selectedKey = 0;
+    isCaptureSelected = false;
+    selectedSample = 0;
+    lastStatus = KEYMAP_FEATURE_STATUS_OK;
+    USB_HIDFeatureReportCallbackRegister(&KeymapFeature_onGet, &KeymapFeature_onSet);
+}
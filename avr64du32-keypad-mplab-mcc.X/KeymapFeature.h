@@ -0,0 +1,55 @@
+#ifndef KEYMAPFEATURE_H
+#define	KEYMAPFEATURE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+    
+    //Feature report layout (USB_HID_FEATURE_REPORT_SIZE bytes, after the report ID, which the HID driver handles)
+    //SET_REPORT: [command] [count or key] [entries...]
+    //GET_REPORT: [entries in keymap] [count] [entries...] ... [pending changes] [status of the last command]
+    //Each entry is [keymap entry] [type] [modifier] [keycode], where keymap entry = (layer * KEYMAP_KEYS) + key
+    
+    //Select the first entry returned by GET_REPORT - [KEYMAP_FEATURE_SELECT] [keymap entry]
+#define KEYMAP_FEATURE_SELECT 0x01
+    
+    //Change keys - [KEYMAP_FEATURE_WRITE] [count] [entries...]
+#define KEYMAP_FEATURE_WRITE 0x02
+    
+    //Write the changes to EEPROM now
+#define KEYMAP_FEATURE_COMMIT 0x03
+    
+    //Restore the default keymap
+#define KEYMAP_FEATURE_DEFAULTS 0x04
+    
+    //Start or stop a pin capture (see PinCapture.h) - [KEYMAP_FEATURE_CAPTURE] [mode]
+#define KEYMAP_FEATURE_CAPTURE 0x05
+#define KEYMAP_FEATURE_CAPTURE_STOP 0x00
+#define KEYMAP_FEATURE_CAPTURE_SCAN 0x01
+#define KEYMAP_FEATURE_CAPTURE_BURST 0x02
+    
+    //Return captured samples from GET_REPORT, from the oldest + offset - [KEYMAP_FEATURE_CAPTURE_READ] [offset]
+    //GET_REPORT: [capture state] [count] [samples...] ... [samples held] [status of the last command]
+    //KEYMAP_FEATURE_SELECT returns GET_REPORT to the keymap
+#define KEYMAP_FEATURE_CAPTURE_READ 0x06
+    
+    //Offset of the first entry
+#define KEYMAP_FEATURE_ENTRY_OFFSET 2
+    
+    //Size of an entry
+#define KEYMAP_FEATURE_ENTRY_SIZE 4
+    
+    //Status of the last command
+#define KEYMAP_FEATURE_STATUS_OK 0x00
+#define KEYMAP_FEATURE_STATUS_ERROR 0x01
+    
+    //Handle the keymap feature report
+    void KeymapFeature_Initialize(void);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* KEYMAPFEATURE_H */
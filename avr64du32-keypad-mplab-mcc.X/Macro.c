@@ -0,0 +1,337 @@
+#include "Macro.h"
+
+#include <avr/eeprom.h>
+#include <stddef.h>
+#include <util/atomic.h>
+
+#include "mcc_generated_files/usb/usb_hid/usb_hid_keyboard.h"
+#include "mcc_generated_files/usb/usb_hid/usb_hid_keycodes.h"
+#include "KeyReporting.h"
+#include "KeyEventQueue.h"
+
+//Event time - bit 7 is set for a release, bits 6:0 are the ticks since the last event
+#define MACRO_RELEASE_bm 0x80
+#define MACRO_TICKS_gm 0x7F
+
+//Recorded event - a key usage of HID_KEY_NONE is a pause
+typedef struct {
+    uint8_t time;
+    uint8_t usage;
+} MACRO_EVENT_t;
+
+//Macro as stored in EEPROM (the checksum is written last)
+typedef struct {
+    uint8_t version;
+    uint8_t length;
+    MACRO_EVENT_t events[MACRO_EVENTS];
+    uint8_t checksum;
+} MACRO_EEPROM_t;
+
+//Macro in EEPROM
+static MACRO_EEPROM_t EEMEM macroEEPROM;
+
+//Macro in RAM - recorded into, played from, and written to EEPROM
+static MACRO_EEPROM_t macro;
+
+//Macro state
+static MACRO_STATE state = MACRO_IDLE;
+
+//Recording - the keys at the last event, and when it was sampled (us)
+static USB_KEYBOARD_REPORT_DATA_t recordReport;
+static uint32_t recordTime = 0;
+static bool isFirstEvent = true;
+
+//Playing - the next event, the keys sent, and the timer for the pauses
+static uint8_t playIndex = 0;
+static USB_KEYBOARD_REPORT_DATA_t playReport;
+static TIMER_WHEEL_HANDLE_t playTimer = TIMER_WHEEL_NONE;
+
+//EEPROM write - next byte, or sizeof(MACRO_EEPROM_t) when idle
+static uint8_t writeIndex = sizeof(MACRO_EEPROM_t);
+
+//Checksum of a stored macro
+static uint8_t Macro_checksum(const MACRO_EEPROM_t* stored)
+{
+    const uint8_t* data = (const uint8_t*) stored;
+    uint8_t sum = 0;
+    
+    for (uint8_t i = 0; i < offsetof(MACRO_EEPROM_t, checksum); i++)
+    {
+        sum += data[i];
+    }
+    
+    return ~sum;
+}
+
+//Add an event, with pauses in front of it if the wait does not fit
+//Returns false if the macro is full
+static bool Macro_addEvent(uint16_t ticks, bool isRelease, uint8_t usage)
+{
+    while (ticks > MACRO_TICKS_gm)
+    {
+        if (!Macro_addEvent(MACRO_TICKS_gm, false, HID_KEY_NONE))
+        {
+            return false;
+        }
+        ticks -= MACRO_TICKS_gm;
+    }
+    
+    if (macro.length >= MACRO_EVENTS)
+    {
+        return false;
+    }
+    
+    macro.events[macro.length].time = ticks | ((isRelease) ? MACRO_RELEASE_bm : 0);
+    macro.events[macro.length].usage = usage;
+    macro.length++;
+    
+    return true;
+}
+
+//Stop recording, and start writing the macro to EEPROM
+static void Macro_stopRecording(void)
+{
+    macro.version = MACRO_VERSION;
+    macro.checksum = Macro_checksum(&macro);
+    
+    writeIndex = 0;
+    state = MACRO_IDLE;
+}
+
+//Apply an event to the keys sent
+//Returns false for a pause
+static bool Macro_apply(MACRO_EVENT_t event)
+{
+    bool isRelease = ((event.time & MACRO_RELEASE_bm) != 0);
+    
+    if (event.usage == HID_KEY_NONE)
+    {
+        return false;
+    }
+    
+    if (event.usage >= HID_LEFT_CTRL)
+    {
+        //Modifier keys are bits of the modifier byte
+        uint8_t modifier = (1 << (event.usage - HID_LEFT_CTRL));
+        
+        if (isRelease)
+        {
+            playReport.Modifier &= ~modifier;
+        }
+        else
+        {
+            playReport.Modifier |= modifier;
+        }
+        
+        return true;
+    }
+    
+    uint8_t index = KeyReport_getKeyIndex(&playReport, (isRelease) ? event.usage : HID_KEY_NONE);
+    
+    if (index != UINT8_MAX)
+    {
+        playReport.KeyCode[index] = (isRelease) ? HID_KEY_NONE : event.usage;
+    }
+    
+    return true;
+}
+
+//The pause before the next event is over - send events until the next pause
+static void Macro_onTimer(TIMER_WHEEL_HANDLE_t timer)
+{
+    while (playIndex < macro.length)
+    {
+        //Try again on the next tick
+        if (KeyEventQueue_IsFull())
+        {
+            TimerWheel_Arm(timer, MACRO_TICK_MS, 0);
+            return;
+        }
+        
+        if (Macro_apply(macro.events[playIndex]))
+        {
+            KeyEventQueue_Push(&playReport);
+        }
+        
+        playIndex++;
+        
+        //Wait for the next event
+        if (playIndex < macro.length)
+        {
+            uint8_t ticks = macro.events[playIndex].time & MACRO_TICKS_gm;
+            
+            if (ticks != 0)
+            {
+                TimerWheel_Arm(timer, (uint32_t) ticks * MACRO_TICK_MS, 0);
+                return;
+            }
+        }
+    }
+    
+    //Release all keys at the end
+    if (KeyEventQueue_IsFull())
+    {
+        TimerWheel_Arm(timer, MACRO_TICK_MS, 0);
+        return;
+    }
+    
+    KeyReport_clearReport(&playReport);
+    KeyEventQueue_Push(&playReport);
+    state = MACRO_IDLE;
+}
+
+//Load the macro from EEPROM
+void Macro_Initialize(void)
+{
+    eeprom_read_block(&macro, &macroEEPROM, sizeof(macro));
+    
+    //Blank or invalid EEPROM - no macro
+    if ((macro.version != MACRO_VERSION) || (macro.length > MACRO_EVENTS) 
+            || (macro.checksum != Macro_checksum(&macro)))
+    {
+        macro.length = 0;
+    }
+    
+    state = MACRO_IDLE;
+    writeIndex = sizeof(MACRO_EEPROM_t);
+    
+    if (playTimer == TIMER_WHEEL_NONE)
+    {
+        playTimer = TimerWheel_Create(&Macro_onTimer);
+    }
+}
+
+//Start recording, or stop recording and write the macro to EEPROM
+void Macro_ToggleRecord(void)
+{
+    if (state == MACRO_RECORDING)
+    {
+        Macro_stopRecording();
+    }
+    else if ((state == MACRO_IDLE) && (!Macro_IsBusy()))
+    {
+        macro.length = 0;
+        KeyReport_clearReport(&recordReport);
+        isFirstEvent = true;
+        state = MACRO_RECORDING;
+    }
+}
+
+//Call with every report queued while recording
+void Macro_Record(const USB_KEYBOARD_REPORT_DATA_t* keyReport, uint32_t time)
+{
+    if (state != MACRO_RECORDING)
+    {
+        return;
+    }
+    
+    //Time since the last event, rounded to ticks
+    uint32_t gap = (isFirstEvent) ? 0 : ((time - recordTime) / 1000);
+    if (gap > MACRO_MAX_GAP)
+    {
+        gap = MACRO_MAX_GAP;
+    }
+    uint16_t ticks = (gap + (MACRO_TICK_MS / 2)) / MACRO_TICK_MS;
+    
+    recordTime = time;
+    isFirstEvent = false;
+    
+    bool isOK = true;
+    
+    //Modifiers that changed
+    uint8_t changed = (*keyReport).Modifier ^ recordReport.Modifier;
+    for (uint8_t bit = 0; (bit < 8) && (isOK); bit++)
+    {
+        if (changed & (1 << bit))
+        {
+            isOK = Macro_addEvent(ticks, (((*keyReport).Modifier & (1 << bit)) == 0), HID_LEFT_CTRL + bit);
+            ticks = 0;
+        }
+    }
+    
+    //Keys released, then keys pressed
+    for (uint8_t i = 0; (i < USB_HID_KEYBOARD_REPORT_KEYNUM) && (isOK); i++)
+    {
+        uint8_t usage = recordReport.KeyCode[i];
+        
+        if ((usage != HID_KEY_NONE) 
+                && (KeyReport_getKeyIndex((USB_KEYBOARD_REPORT_DATA_t*) keyReport, usage) == UINT8_MAX))
+        {
+            isOK = Macro_addEvent(ticks, true, usage);
+            ticks = 0;
+        }
+    }
+    
+    for (uint8_t i = 0; (i < USB_HID_KEYBOARD_REPORT_KEYNUM) && (isOK); i++)
+    {
+        uint8_t usage = (*keyReport).KeyCode[i];
+        
+        if ((usage != HID_KEY_NONE) && (KeyReport_getKeyIndex(&recordReport, usage) == UINT8_MAX))
+        {
+            isOK = Macro_addEvent(ticks, false, usage);
+            ticks = 0;
+        }
+    }
+    
+    recordReport = *keyReport;
+    
+    //Full - keep what fits (playing releases all keys at the end)
+    if (!isOK)
+    {
+        Macro_stopRecording();
+    }
+}
+
+//Play the macro through the key event queue
+void Macro_Play(void)
+{
+    if ((state != MACRO_IDLE) || (macro.length == 0) || (playTimer == TIMER_WHEEL_NONE))
+    {
+        return;
+    }
+    
+    KeyReport_clearReport(&playReport);
+    playIndex = 0;
+    state = MACRO_PLAYING;
+    
+    //The first event waits for one tick, so it follows the report of the key press
+    TimerWheel_Arm(playTimer, MACRO_TICK_MS, 0);
+}
+
+//Returns the macro state
+MACRO_STATE Macro_GetState(void)
+{
+    return state;
+}
+
+//Returns the number of events in the macro
+uint8_t Macro_GetLength(void)
+{
+    return macro.length;
+}
+
+//Write the macro to EEPROM, one byte at a time
+bool Macro_Service(void)
+{
+    if (writeIndex >= sizeof(MACRO_EEPROM_t))
+    {
+        return false;
+    }
+    
+    //Don't wait for the EEPROM
+    if (!eeprom_is_ready())
+    {
+        return true;
+    }
+    
+    eeprom_update_byte(((uint8_t*) &macroEEPROM) + writeIndex, ((const uint8_t*) &macro)[writeIndex]);
+    writeIndex++;
+    
+    return (writeIndex < sizeof(MACRO_EEPROM_t));
+}
+
+//Returns true while the macro is waiting to be written to EEPROM
+bool Macro_IsBusy(void)
+{
+    return (writeIndex < sizeof(MACRO_EEPROM_t));
+}
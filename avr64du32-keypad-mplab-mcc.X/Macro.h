@@ -0,0 +1,61 @@
+#ifndef MACRO_H
+#define	MACRO_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+#include "mcc_generated_files/usb/usb_hid/usb_protocol_hid.h"
+#include "TimerWheel.h"
+    
+    //Time unit of the recording (ms) - the software timer tick
+#define MACRO_TICK_MS TIMER_WHEEL_TICK_MS
+    
+    //Number of events in the macro (2 bytes each in EEPROM)
+#define MACRO_EVENTS 48
+    
+    //Layout version of the macro in EEPROM - change to clear the macro
+#define MACRO_VERSION 0x01
+    
+    //Longest pause recorded between events (ms) - longer pauses are shortened to this
+#define MACRO_MAX_GAP 2000
+    
+    //Macro states
+    typedef enum {
+        MACRO_IDLE = 0, MACRO_RECORDING, MACRO_PLAYING
+    } MACRO_STATE;
+    
+    //Load the macro from EEPROM - call after TimerWheel_Initialize
+    void Macro_Initialize(void);
+    
+    //Start recording, or stop recording and write the macro to EEPROM
+    //Ignored while playing, or while the last recording is being written
+    void Macro_ToggleRecord(void);
+    
+    //Call with every report queued while recording - time is when the keys were sampled (us)
+    void Macro_Record(const USB_KEYBOARD_REPORT_DATA_t* keyReport, uint32_t time);
+    
+    //Play the macro through the key event queue - ignored while recording or playing
+    void Macro_Play(void);
+    
+    //Returns the macro state
+    MACRO_STATE Macro_GetState(void);
+    
+    //Returns the number of events in the macro
+    uint8_t Macro_GetLength(void);
+    
+    //Write the macro to EEPROM, one byte at a time - call from the main loop
+    //Returns true while a write is in progress (call again without sleeping)
+    bool Macro_Service(void);
+    
+    //Returns true while the macro is waiting to be written to EEPROM
+    bool Macro_IsBusy(void);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* MACRO_H */
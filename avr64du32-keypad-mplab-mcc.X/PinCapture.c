@@ -0,0 +1,159 @@
+#include "PinCapture.h"
+
+#include <util/atomic.h>
+
+#include "mcc_generated_files/system/system.h"
+#include "ButtonScan.h"
+#include "IsrTiming.h"
+
+#if (PIN_CAPTURE_SIZE & (PIN_CAPTURE_SIZE - 1)) || (PIN_CAPTURE_SIZE > 128)
+#error "PIN_CAPTURE_SIZE must be a power of 2, up to 128"
+#endif
+
+#define PIN_CAPTURE_MASK (PIN_CAPTURE_SIZE - 1)
+
+//Samples
+static volatile uint8_t samples[PIN_CAPTURE_SIZE];
+
+//Next sample to write, and the number of samples held
+static volatile uint8_t next = 0;
+static volatile uint8_t count = 0;
+
+//Capture state
+static volatile PIN_CAPTURE_STATE state = PIN_CAPTURE_STOPPED;
+
+//Sample from the last key scan (to find the edge)
+static uint8_t lastSample = 0x00;
+
+//Add a sample - returns true if the buffer is now full
+static bool PinCapture_add(uint8_t sample)
+{
+    samples[next] = sample;
+    next = (next + 1) & PIN_CAPTURE_MASK;
+    
+    if (count < PIN_CAPTURE_SIZE)
+    {
+        count++;
+    }
+    
+    return (count == PIN_CAPTURE_SIZE);
+}
+
+//Empty the buffer and set the state
+static void PinCapture_restart(PIN_CAPTURE_STATE newState)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        RTC_DisablePITInterrupt();
+        
+        next = 0;
+        count = 0;
+        state = newState;
+    }
+}
+
+//RTC PIT - take a burst sample
+static void PinCapture_onPIT(void)
+{
+    uint32_t start = IsrTiming_Start();
+    
+    if ((state == PIN_CAPTURE_BURST) && (PinCapture_add(ButtonScan_Sample())))
+    {
+        //Full - stop the burst
+        RTC_DisablePITInterrupt();
+        state = PIN_CAPTURE_STOPPED;
+    }
+    
+    IsrTiming_End(ISR_TIMING_PIT, start);
+}
+
+//Stop and empty the capture
+void PinCapture_Initialize(void)
+{
+    PinCapture_restart(PIN_CAPTURE_STOPPED);
+    RTC_SetPITIsrCallback(&PinCapture_onPIT);
+}
+
+//Empty the buffer and record every key scan
+void PinCapture_StartScan(void)
+{
+    PinCapture_restart(PIN_CAPTURE_SCAN);
+}
+
+//Empty the buffer and wait for an edge
+void PinCapture_StartBurst(void)
+{
+    PinCapture_restart(PIN_CAPTURE_ARMED);
+}
+
+//Stop recording, and keep the samples
+void PinCapture_Stop(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        RTC_DisablePITInterrupt();
+        state = PIN_CAPTURE_STOPPED;
+    }
+}
+
+//Call from the key scan with the raw sample
+void PinCapture_Scan(uint8_t sample)
+{
+    if (state == PIN_CAPTURE_SCAN)
+    {
+        PinCapture_add(sample);
+    }
+    else if ((state == PIN_CAPTURE_ARMED) && (sample != lastSample))
+    {
+        //Keep the sample from before the edge, then sample at the burst rate
+        PinCapture_add(lastSample);
+        PinCapture_add(sample);
+        
+        state = PIN_CAPTURE_BURST;
+        
+        //Drop the flag from a period that passed while the interrupt was off
+        RTC.PITINTFLAGS = RTC_PI_bm;
+        RTC_EnablePITInterrupt();
+    }
+    
+    lastSample = sample;
+}
+
+//Returns the capture state
+PIN_CAPTURE_STATE PinCapture_GetState(void)
+{
+    return state;
+}
+
+//Returns true while recording or waiting for an edge
+bool PinCapture_IsActive(void)
+{
+    return (state != PIN_CAPTURE_STOPPED);
+}
+
+//Returns the number of samples held
+uint8_t PinCapture_GetCount(void)
+{
+    return count;
+}
+
+//Copy up to length samples, from the oldest + offset
+uint8_t PinCapture_Read(uint8_t offset, uint8_t* data, uint8_t length)
+{
+    uint8_t copied = 0;
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        //The oldest sample is count samples behind the next write
+        uint8_t index = (next - count + offset) & PIN_CAPTURE_MASK;
+        
+        while ((copied < length) && ((uint16_t) offset + copied < count))
+        {
+            data[copied] = samples[index];
+            index = (index + 1) & PIN_CAPTURE_MASK;
+            copied++;
+        }
+    }
+    
+    return copied;
+}
@@ -0,0 +1,68 @@
+#ifndef PINCAPTURE_H
+#define	PINCAPTURE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+    //Raw button samples for debounce analysis
+    //Each sample is one byte - the raw key bitmap of ButtonScan_Sample (bits are BUTTON_SCAN_*_bp, 1 = pressed)
+    //Replaying the samples through ButtonScan_Update gives the same keys as the device
+    
+    //Number of samples held (power of 2, up to 128)
+#define PIN_CAPTURE_SIZE 128
+    
+    //Time between burst samples (us) - 8 cycles of the 32.768 kHz RTC clock (RTC PIT)
+#define PIN_CAPTURE_BURST_PERIOD 244
+    
+    //Capture states
+    typedef enum {
+        //Not recording - the samples are kept for reading
+        PIN_CAPTURE_STOPPED = 0,
+    
+        //Recording every key scan (5 ms), overwriting the oldest sample
+        PIN_CAPTURE_SCAN,
+    
+        //Waiting for a button to change at a key scan
+        PIN_CAPTURE_ARMED,
+    
+        //Recording every PIN_CAPTURE_BURST_PERIOD until the buffer is full
+        PIN_CAPTURE_BURST
+    } PIN_CAPTURE_STATE;
+    
+    //Stop and empty the capture
+    void PinCapture_Initialize(void);
+    
+    //Empty the buffer and record every key scan
+    void PinCapture_StartScan(void);
+    
+    //Empty the buffer and wait for an edge, then record at the burst rate
+    void PinCapture_StartBurst(void);
+    
+    //Stop recording, and keep the samples
+    void PinCapture_Stop(void);
+    
+    //Call from the key scan with the raw sample
+    void PinCapture_Scan(uint8_t sample);
+    
+    //Returns the capture state
+    PIN_CAPTURE_STATE PinCapture_GetState(void);
+    
+    //Returns true while recording or waiting for an edge
+    bool PinCapture_IsActive(void);
+    
+    //Returns the number of samples held
+    uint8_t PinCapture_GetCount(void);
+    
+    //Copy up to length samples, from the oldest + offset
+    //Returns the number of samples copied
+    uint8_t PinCapture_Read(uint8_t offset, uint8_t* data, uint8_t length);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PINCAPTURE_H */
@@ -0,0 +1,80 @@
+#include "ScanLatency.h"
+
+#include <stdbool.h>
+#include <util/atomic.h>
+
+#include "usb_hid_transfer.h"
+#include "Timebase.h"
+
+//Is a sample waiting for its report to be sent?
+static volatile bool isPending = false;
+
+//Time (us) and source of the pending sample
+static volatile uint32_t pendingTime = 0;
+static volatile SCAN_LATENCY_SOURCE pendingSource = SCAN_LATENCY_FREE_RUNNING;
+
+//Time from sample to report sent, in SCAN_LATENCY_BIN_US bins
+static volatile uint16_t histogram[SCAN_LATENCY_SOURCE_COUNT][SCAN_LATENCY_BINS];
+
+//A keyboard report has been sent - bin the time since it was sampled
+static void ScanLatency_onReportSent(void)
+{
+    uint32_t bin;
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (!isPending)
+        {
+            return;
+        }
+        
+        bin = (Timebase_GetMicrosFromISR() - pendingTime) / SCAN_LATENCY_BIN_US;
+        if (bin >= SCAN_LATENCY_BINS)
+        {
+            bin = SCAN_LATENCY_BINS - 1;
+        }
+        
+        //Saturate instead of wrapping
+        if (histogram[pendingSource][bin] != UINT16_MAX)
+        {
+            histogram[pendingSource][bin]++;
+        }
+        
+        isPending = false;
+    }
+}
+
+//Start measuring the time from key sample to report sent
+void ScanLatency_Initialize(void)
+{
+    isPending = false;
+    USB_HIDKeyboardReportSentCallbackRegister(&ScanLatency_onReportSent);
+}
+
+//Call when a key sample has queued a report
+void ScanLatency_Sampled(SCAN_LATENCY_SOURCE source, uint32_t time)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        //Keep the oldest sample if the last report has not gone out yet
+        if (!isPending)
+        {
+            pendingTime = time;
+            pendingSource = source;
+            isPending = true;
+        }
+    }
+}
+
+//Copy and clear the histogram for source
+void ScanLatency_GetHistogram(SCAN_LATENCY_SOURCE source, uint16_t* bins)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        for (uint8_t i = 0; i < SCAN_LATENCY_BINS; i++)
+        {
+            bins[i] = histogram[source][i];
+            histogram[source][i] = 0;
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef SCANLATENCY_H
+#define	SCANLATENCY_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+    
+    //Width of each histogram bin (us) - 4 bins per USB frame
+#define SCAN_LATENCY_BIN_US 250
+    
+    //Number of histogram bins (6 ms, last bin collects the rest)
+#define SCAN_LATENCY_BINS 24
+    
+    //What triggered the key scan
+    typedef enum {
+        SCAN_LATENCY_FREE_RUNNING = 0, SCAN_LATENCY_SOF_ALIGNED, SCAN_LATENCY_SOURCE_COUNT
+    } SCAN_LATENCY_SOURCE;
+    
+    //Start measuring the time from key sample to report sent
+    void ScanLatency_Initialize(void);
+    
+    //Call when a key sample has queued a report - time is the timebase time (us) the keys were sampled at
+    void ScanLatency_Sampled(SCAN_LATENCY_SOURCE source, uint32_t time);
+    
+    //Copy and clear the histogram for source (bins must hold SCAN_LATENCY_BINS entries)
+    void ScanLatency_GetHistogram(SCAN_LATENCY_SOURCE source, uint16_t* bins);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* SCANLATENCY_H */
@@ -0,0 +1,157 @@
+#include "ScanRate.h"
+
+#include <util/atomic.h>
+
+#include "mcc_generated_files/system/system.h"
+
+//Is the scan running at the active rate?
+static volatile bool isFast = true;
+
+//Scans since the last activity
+static volatile uint16_t idleScans = 0;
+
+//Statistics
+static volatile SCAN_RATE_STATS_t stats;
+
+//Switch back to the active rate
+static void ScanRate_setFast(void)
+{
+    RTC_WritePeriod(SCAN_RATE_ACTIVE_PERIOD);
+    isFast = true;
+}
+
+#ifdef SCAN_RATE_IDLE_INTERRUPT_WAKE
+
+//Enable or disable the wake on key edges
+static void ScanRate_setKeyWake(bool enable)
+{
+    if (enable)
+    {
+        SW0_EnableInterruptForBothEdges();
+        BUTTON_EXTERNAL_EnableInterruptForBothEdges();
+        BUTTON_1_EnableInterruptForBothEdges();
+        BUTTON_2_EnableInterruptForBothEdges();
+        BUTTON_3_EnableInterruptForBothEdges();
+        BUTTON_4_EnableInterruptForBothEdges();
+    }
+    else
+    {
+        SW0_DisableInterruptOnChange();
+        BUTTON_EXTERNAL_DisableInterruptOnChange();
+        BUTTON_1_DisableInterruptOnChange();
+        BUTTON_2_DisableInterruptOnChange();
+        BUTTON_3_DisableInterruptOnChange();
+        BUTTON_4_DisableInterruptOnChange();
+    }
+}
+
+#endif
+
+//Resume scanning at the active rate
+static void ScanRate_resume(void)
+{
+    idleScans = 0;
+    
+    if (isFast)
+    {
+        return;
+    }
+    
+    ScanRate_setFast();
+    
+#ifdef SCAN_RATE_IDLE_INTERRUPT_WAKE
+    ScanRate_setKeyWake(false);
+    
+    //Scan right away
+    RTC_WriteCounter(SCAN_RATE_ACTIVE_PERIOD);
+    RTC_ClearOVFInterruptFlag();
+    RTC_EnableOVFInterrupt();
+#endif
+}
+
+#ifdef SCAN_RATE_IDLE_INTERRUPT_WAKE
+
+//A key changed while scanning was stopped
+static void ScanRate_onKeyWake(void)
+{
+    stats.keyWakes++;
+    ScanRate_resume();
+}
+
+#endif
+
+//Start scanning at the active rate
+void ScanRate_Initialize(void)
+{
+#ifdef SCAN_RATE_IDLE_INTERRUPT_WAKE
+    SW0_SetInterruptHandler(&ScanRate_onKeyWake);
+    BUTTON_EXTERNAL_SetInterruptHandler(&ScanRate_onKeyWake);
+    BUTTON_1_SetInterruptHandler(&ScanRate_onKeyWake);
+    BUTTON_2_SetInterruptHandler(&ScanRate_onKeyWake);
+    BUTTON_3_SetInterruptHandler(&ScanRate_onKeyWake);
+    BUTTON_4_SetInterruptHandler(&ScanRate_onKeyWake);
+#endif
+    
+    idleScans = 0;
+    ScanRate_setFast();
+}
+
+//Update the scan rate - call at the end of each scan
+void ScanRate_Update(bool isActive)
+{
+    if (isFast)
+    {
+        stats.activeScans++;
+    }
+    else
+    {
+        stats.idleScans++;
+    }
+    
+    if (isActive)
+    {
+        ScanRate_resume();
+        return;
+    }
+    
+    if (idleScans < SCAN_RATE_IDLE_SCANS)
+    {
+        idleScans++;
+        return;
+    }
+    
+    //Idle - slow down (or stop) the scan
+    if (isFast)
+    {
+#ifdef SCAN_RATE_IDLE_INTERRUPT_WAKE
+        RTC_DisableOVFInterrupt();
+        isFast = false;
+        ScanRate_setKeyWake(true);
+#else
+        RTC_WritePeriod(SCAN_RATE_IDLE_PERIOD);
+        isFast = false;
+#endif
+    }
+}
+
+//Return to the active rate from the main loop
+void ScanRate_Wake(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        ScanRate_resume();
+    }
+}
+
+//Copy and clear the scan statistics
+void ScanRate_GetStats(SCAN_RATE_STATS_t* copy)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *copy = stats;
+        
+        stats.activeScans = 0;
+        stats.idleScans = 0;
+        stats.keyWakes = 0;
+    }
+}
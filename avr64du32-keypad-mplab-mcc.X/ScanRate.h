@@ -0,0 +1,54 @@
+#ifndef SCANRATE_H
+#define	SCANRATE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+    //RTC period while keys are active (RTC counts at 32.768 kHz, 5 ms)
+    //This period also debounces the keys
+#define SCAN_RATE_ACTIVE_PERIOD 0xA3
+    
+    //RTC period of the idle keep-alive scan (20 ms)
+#define SCAN_RATE_IDLE_PERIOD 0x28F
+    
+    //Number of scans without activity before the scan rate drops (1 s)
+#define SCAN_RATE_IDLE_SCANS 200
+    
+    //If set, scanning stops completely when idle and restarts on a key edge
+    //#define SCAN_RATE_IDLE_INTERRUPT_WAKE
+    
+    //Scan statistics
+    typedef struct {
+        //Scans at the active rate
+        uint16_t activeScans;
+        
+        //Scans at the idle rate
+        uint16_t idleScans;
+        
+        //Wake-ups from a key edge
+        uint16_t keyWakes;
+    } SCAN_RATE_STATS_t;
+    
+    //Start scanning at the active rate
+    void ScanRate_Initialize(void);
+    
+    //Update the scan rate - call at the end of each scan
+    //isActive is true while a key is pressed, bouncing or a timer is running
+    void ScanRate_Update(bool isActive);
+    
+    //Return to the active rate from the main loop (e.g. when a timer is started)
+    void ScanRate_Wake(void);
+    
+    //Copy and clear the scan statistics
+    void ScanRate_GetStats(SCAN_RATE_STATS_t* stats);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* SCANRATE_H */
+
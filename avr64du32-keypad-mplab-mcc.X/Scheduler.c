@@ -0,0 +1,129 @@
+#include "Scheduler.h"
+
+#include <stddef.h>
+#include <util/atomic.h>
+
+#include "Timebase.h"
+
+#if SCHEDULER_TASKS > 8
+#error "The ready mask holds up to 8 tasks"
+#endif
+
+//Task functions
+static SCHEDULER_TASK_t tasks[SCHEDULER_TASKS];
+
+//Tasks waiting to run (bit n = task n)
+static volatile uint8_t readyTasks = 0;
+
+//Runtime statistics, and the time each was cleared
+static SCHEDULER_STATS_t stats[SCHEDULER_TASKS];
+static uint32_t windowStart[SCHEDULER_TASKS];
+
+//Clear the task table
+void Scheduler_Initialize(void)
+{
+    uint32_t now = Timebase_GetMicros();
+    
+    for (uint8_t i = 0; i < SCHEDULER_TASKS; i++)
+    {
+        tasks[i] = NULL;
+        
+        stats[i].runs = 0;
+        stats[i].maxTime = 0;
+        stats[i].totalTime = 0;
+        windowStart[i] = now;
+    }
+    
+    readyTasks = 0;
+}
+
+//Set the function of a task
+void Scheduler_AddTask(uint8_t task, SCHEDULER_TASK_t function)
+{
+    if (task >= SCHEDULER_TASKS)
+    {
+        return;
+    }
+    
+    tasks[task] = function;
+}
+
+//Make a task ready to run
+void Scheduler_Post(uint8_t task)
+{
+    if (task >= SCHEDULER_TASKS)
+    {
+        return;
+    }
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        readyTasks |= (1 << task);
+    }
+}
+
+//Returns true if any task is ready
+bool Scheduler_IsReady(void)
+{
+    return (readyTasks != 0);
+}
+
+//Run the highest priority task that is ready
+bool Scheduler_RunNext(void)
+{
+    uint8_t task = 0;
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (readyTasks == 0)
+        {
+            return false;
+        }
+        
+        //Lowest bit is the highest priority
+        while (!(readyTasks & (1 << task)))
+        {
+            task++;
+        }
+        
+        //Clear before running, so a post during the run is not lost
+        readyTasks &= ~(1 << task);
+    }
+    
+    if (tasks[task] == NULL)
+    {
+        return true;
+    }
+    
+    uint32_t start = Timebase_GetMicros();
+    tasks[task]();
+    uint32_t time = Timebase_Elapsed(start);
+    
+    stats[task].runs++;
+    stats[task].totalTime += time;
+    if (time > stats[task].maxTime)
+    {
+        stats[task].maxTime = (time > UINT16_MAX) ? UINT16_MAX : time;
+    }
+    
+    return true;
+}
+
+//Copy and clear the runtime statistics of a task
+void Scheduler_GetStats(uint8_t task, SCHEDULER_STATS_t* copy)
+{
+    if (task >= SCHEDULER_TASKS)
+    {
+        return;
+    }
+    
+    uint32_t now = Timebase_GetMicros();
+    
+    *copy = stats[task];
+    copy->window = now - windowStart[task];
+    
+    stats[task].runs = 0;
+    stats[task].maxTime = 0;
+    stats[task].totalTime = 0;
+    windowStart[task] = now;
+}
@@ -0,0 +1,55 @@
+#ifndef SCHEDULER_H
+#define	SCHEDULER_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+    //Number of tasks (up to 8) - the task number is its priority (0 runs first)
+#define SCHEDULER_TASKS 5
+    
+    //Task function - runs to completion, and posts itself to run again
+    typedef void (*SCHEDULER_TASK_t)(void);
+    
+    //Task runtime statistics
+    typedef struct {
+        //Times the task ran
+        uint16_t runs;
+    
+        //Longest run (us)
+        uint16_t maxTime;
+    
+        //Total time running (us)
+        uint32_t totalTime;
+    
+        //Time since the statistics were cleared (us) - CPU use is totalTime / window
+        uint32_t window;
+    } SCHEDULER_STATS_t;
+    
+    //Clear the task table
+    void Scheduler_Initialize(void);
+    
+    //Set the function of a task
+    void Scheduler_AddTask(uint8_t task, SCHEDULER_TASK_t function);
+    
+    //Make a task ready to run - safe to call from interrupts
+    void Scheduler_Post(uint8_t task);
+    
+    //Returns true if any task is ready
+    bool Scheduler_IsReady(void);
+    
+    //Run the highest priority task that is ready
+    //Returns false if no task was ready
+    bool Scheduler_RunNext(void);
+    
+    //Copy and clear the runtime statistics of a task
+    void Scheduler_GetStats(uint8_t task, SCHEDULER_STATS_t* stats);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* SCHEDULER_H */
@@ -0,0 +1,144 @@
+#include "SleepManager.h"
+
+#include <avr/sleep.h>
+#include <util/atomic.h>
+
+#include "mcc_generated_files/system/system.h"
+#include "mcc_generated_files/usb/usb0.h"
+#include "usb_core_events.h"
+#include "IsrTiming.h"
+
+//Deepest level allowed for the next sleep
+static SLEEP_LEVEL allowedLevel = SLEEP_LEVEL_POWER_DOWN;
+
+//Statistics
+static volatile SLEEP_STATS_t stats;
+
+//Woken by a USB bus event - mask the interrupts and leave the flags for USBDevice_Handle
+static void SleepManager_onUSBBusEvent(void)
+{
+    uint32_t start = IsrTiming_Start();
+    
+    USB0_InterruptsDisable();
+    
+    IsrTiming_End(ISR_TIMING_USB0_BUS, start);
+}
+
+//Woken by a USB transaction - as above, timed on its own as it runs at level 1
+static void SleepManager_onUSBTransaction(void)
+{
+    uint32_t start = IsrTiming_Start();
+    
+    USB0_InterruptsDisable();
+    
+    IsrTiming_End(ISR_TIMING_USB0_TRNCOMPL, start);
+}
+
+//Hook the USB0 interrupts so USB activity wakes the CPU
+void SleepManager_Initialize(void)
+{
+    USB0_InterruptsDisable();
+    USB0_TrnComplCallbackRegister(&SleepManager_onUSBTransaction);
+    USB0_BusEventCallbackRegister(&SleepManager_onUSBBusEvent);
+}
+
+//Limit the next sleep to level (or lighter)
+void SleepManager_Limit(SLEEP_LEVEL level)
+{
+    if (level < allowedLevel)
+    {
+        allowedLevel = level;
+    }
+}
+
+//Sleep at the deepest level allowed since the last call, then reset the limits
+void SleepManager_Sleep(void)
+{
+    SLEEP_LEVEL level = allowedLevel;
+    allowedLevel = SLEEP_LEVEL_POWER_DOWN;
+    
+    //Peripherals stop in Standby and Power-Down - let the UART finish first
+    if ((level > SLEEP_LEVEL_IDLE) && (!USART1_IsTxDone()))
+    {
+        level = SLEEP_LEVEL_IDLE;
+    }
+    
+    if (level == SLEEP_LEVEL_NONE)
+    {
+        sei();
+        return;
+    }
+    
+    switch (level)
+    {
+        case SLEEP_LEVEL_IDLE:
+        {
+            //Wake on setup, transaction complete and bus events (SOF only if used)
+            uint8_t busEvents = USB_SUSPEND_bm | USB_RESUME_bm | USB_RESET_bm 
+                    | USB_STALLED_bm | USB_UNF_bm | USB_OVF_bm;
+            if (event.SOFCallback != NULL)
+            {
+                busEvents |= USB_SOF_bm;
+            }
+            USB0_BusEventInterruptEnable(busEvents);
+            USB0_TrnComplInterruptEnable(USB_TRNCOMPL_bm | USB_SETUP_bm);
+            
+            set_sleep_mode(SLEEP_MODE_IDLE);
+            break;
+        }
+        case SLEEP_LEVEL_STANDBY:
+        {
+            set_sleep_mode(SLEEP_MODE_STANDBY);
+            break;
+        }
+        default:
+        {
+            set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+        }
+    }
+    
+    uint16_t before = RTC_ReadCounter();
+    
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    
+    //Stop the USB wake sources (already done if USB woke us)
+    USB0_InterruptsDisable();
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        stats.sleepCount[level]++;
+        
+        if (level == SLEEP_LEVEL_IDLE)
+        {
+            //The RTC overflow always wakes the CPU, so it wrapped at most once
+            uint16_t after = RTC_ReadCounter();
+            uint16_t period = RTC_ReadPeriod() + 1;
+            stats.idleCounts += (after >= before) ? (after - before) : ((period - before) + after);
+        }
+    }
+}
+
+//Count the elapsed RTC period for the duty cycle - call from the RTC overflow
+void SleepManager_Tick(void)
+{
+    stats.counts += RTC_ReadPeriod() + 1;
+}
+
+//Copy and clear the sleep statistics
+void SleepManager_GetStats(SLEEP_STATS_t* copy)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *copy = stats;
+        
+        for (uint8_t i = 0; i < SLEEP_LEVEL_COUNT; i++)
+        {
+            stats.sleepCount[i] = 0;
+        }
+        stats.idleCounts = 0;
+        stats.counts = 0;
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef SLEEPMANAGER_H
+#define	SLEEPMANAGER_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+    //Sleep levels, from lightest to deepest
+    typedef enum {
+        SLEEP_LEVEL_NONE = 0, SLEEP_LEVEL_IDLE, SLEEP_LEVEL_STANDBY, 
+                SLEEP_LEVEL_POWER_DOWN, SLEEP_LEVEL_COUNT
+    } SLEEP_LEVEL;
+    
+    //Sleep statistics
+    typedef struct {
+        //Number of times each level was entered
+        uint16_t sleepCount[SLEEP_LEVEL_COUNT];
+        
+        //RTC counts spent asleep in Idle
+        uint32_t idleCounts;
+        
+        //RTC counts elapsed
+        uint32_t counts;
+    } SLEEP_STATS_t;
+    
+    //Hook the USB0 interrupts so USB activity wakes the CPU
+    void SleepManager_Initialize(void);
+    
+    //Limit the next sleep to level (or lighter)
+    void SleepManager_Limit(SLEEP_LEVEL level);
+    
+    //Sleep at the deepest level allowed since the last call, then reset the limits
+    //Must be called with interrupts disabled - returns with interrupts enabled
+    void SleepManager_Sleep(void);
+    
+    //Count the elapsed RTC period for the duty cycle - call from the RTC overflow
+    void SleepManager_Tick(void);
+    
+    //Copy and clear the sleep statistics
+    void SleepManager_GetStats(SLEEP_STATS_t* stats);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* SLEEPMANAGER_H */
+
@@ -0,0 +1,211 @@
+#include "Timebase.h"
+
+#include <stddef.h>
+#include <util/atomic.h>
+
+#include "mcc_generated_files/system/system.h"
+#include "IsrTiming.h"
+
+//Time at the start of the current TCB0 period (us)
+static volatile uint32_t periodStart = 0;
+
+//Length of a TCB0 period (us)
+static uint16_t periodLength = 0;
+
+//Called on each period
+static volatile TIMEBASE_TICK_CALLBACK_t tickCallback = NULL;
+
+//Longest delay from a restart to its interrupt (TCB0 counts)
+static volatile uint16_t maxLatency = 0;
+
+//Is the TCB0 interrupt stopped?
+static volatile bool isSuspended = false;
+
+//Time (us), RTC count and RTC period when the TCB0 interrupt was stopped
+static uint32_t suspendTime = 0;
+static uint16_t suspendCount = 0;
+static uint16_t suspendPeriod = 0;
+
+//TCB0 has restarted
+static void Timebase_onPeriod(void)
+{
+    uint32_t start = IsrTiming_Start();
+    
+    //The count since the restart is how long the interrupt waited
+    uint16_t latency = TCB0_CounterGet();
+    if (latency > maxLatency)
+    {
+        maxLatency = latency;
+    }
+    
+    //A level 1 interrupt may read the time
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        periodStart += periodLength;
+    }
+    
+    if (tickCallback != NULL)
+    {
+        tickCallback();
+    }
+    
+    IsrTiming_End(ISR_TIMING_TCB0, start);
+}
+
+//Start the clock from 0
+void Timebase_Initialize(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        periodLength = ((uint32_t) TCB0_PeriodGet() + 1) / TCB0_COUNTS_PER_US;
+        periodStart = 0;
+        maxLatency = 0;
+        isSuspended = false;
+        TCB0_PeriodCallbackRegister(&Timebase_onPeriod);
+    }
+}
+
+//Set the function called on each period of TCB0
+void Timebase_TickCallbackRegister(TIMEBASE_TICK_CALLBACK_t callback)
+{
+    tickCallback = callback;
+}
+
+//Catch up the time slept and restart the TCB0 interrupt - only call with interrupts disabled
+static void Timebase_catchUp(void)
+{
+    if (!isSuspended)
+    {
+        return;
+    }
+    
+    isSuspended = false;
+    
+    //The RTC overflow interrupt was on, so it woke the CPU and resumed the clock before the RTC could wrap twice
+    //The period is the one at suspend - it only changes in the RTC interrupt, after the resume
+    uint16_t after = RTC_ReadCounter();
+    uint32_t period = (uint32_t) suspendPeriod + 1;
+    uint32_t counts = (after >= suspendCount) ? ((uint32_t) after - suspendCount) : ((period - suspendCount) + after);
+    
+    //RTC counts (32.768 kHz) to us
+    uint32_t slept = (counts * 15625UL) / 512;
+    
+    //TCB0 kept counting - restart the period from where it is now
+    TCB0_PeriodFlagClear();
+    uint16_t count = TCB0_CounterGet();
+    if (TCB0_IsPeriodPending())
+    {
+        TCB0_PeriodFlagClear();
+        count = TCB0_CounterGet();
+    }
+    
+    periodStart = suspendTime + slept - (count / TCB0_COUNTS_PER_US);
+    TCB0_PeriodInterruptEnable();
+}
+
+//Read the start of the current period (us) and the count into it - only call with interrupts disabled
+static void Timebase_read(uint32_t* start, uint16_t* count)
+{
+    //The first read after a wake (e.g. at the start of an ISR) restarts the clock
+    Timebase_catchUp();
+    
+    *start = periodStart;
+    *count = TCB0_CounterGet();
+    
+    //The counter restarted, but the interrupt has not run yet
+    if (TCB0_IsPeriodPending())
+    {
+        //Read the count again, as the first read may be from before the restart
+        *count = TCB0_CounterGet();
+        *start += periodLength;
+    }
+}
+
+//Returns the time (us) - only call with interrupts disabled
+uint32_t Timebase_GetMicrosFromISR(void)
+{
+    uint32_t start;
+    uint16_t count;
+    
+    Timebase_read(&start, &count);
+    
+    return start + (count / TCB0_COUNTS_PER_US);
+}
+
+//Returns a CPU cycle count - only call with interrupts disabled
+uint32_t Timebase_GetCyclesFromISR(void)
+{
+    uint32_t start;
+    uint16_t count;
+    
+    Timebase_read(&start, &count);
+    
+    //Differences stay correct when the multiply wraps
+    return (start * TIMEBASE_CYCLES_PER_US) + ((uint32_t) count * (TIMEBASE_CYCLES_PER_US / TCB0_COUNTS_PER_US));
+}
+
+//Returns the time (us) - safe to call from interrupts
+uint32_t Timebase_GetMicros(void)
+{
+    uint32_t now;
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        now = Timebase_GetMicrosFromISR();
+    }
+    
+    return now;
+}
+
+//Stop the TCB0 interrupt before sleeping - only call with interrupts disabled
+void Timebase_Suspend(void)
+{
+    //Without the RTC overflow, the RTC may wrap any number of times before the wake
+    if ((isSuspended) || (!RTC_IsOVFInterruptEnabled()))
+    {
+        return;
+    }
+    
+    suspendTime = Timebase_GetMicrosFromISR();
+    suspendCount = RTC_ReadCounter();
+    suspendPeriod = RTC_ReadPeriod();
+    
+    TCB0_PeriodInterruptDisable();
+    isSuspended = true;
+}
+
+//Catch up the time and restart the TCB0 interrupt
+void Timebase_Resume(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        Timebase_catchUp();
+    }
+}
+
+//Returns the time (us) since start, across a wrap
+uint32_t Timebase_Elapsed(uint32_t start)
+{
+    return (Timebase_GetMicros() - start);
+}
+
+//Returns true once interval (us) has passed since start
+bool Timebase_HasElapsed(uint32_t start, uint32_t interval)
+{
+    return (Timebase_Elapsed(start) >= interval);
+}
+
+//Returns and clears the longest delay from a TCB0 restart to its interrupt (us)
+uint16_t Timebase_GetMaxLatency(void)
+{
+    uint16_t latency;
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        latency = maxLatency;
+        maxLatency = 0;
+    }
+    
+    //Round up, so any wait shows
+    return (latency + (TCB0_COUNTS_PER_US - 1)) / TCB0_COUNTS_PER_US;
+}
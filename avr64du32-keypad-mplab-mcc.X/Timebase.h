@@ -0,0 +1,60 @@
+#ifndef TIMEBASE_H
+#define	TIMEBASE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+    //Microsecond clock from TCB0 - the period count plus the current count
+    //The clock wraps every 71 minutes, so compare times with Timebase_Elapsed
+    //The RTC and TCB0 both stop in Standby (V-BUS removed), so the clock does not advance there
+    //The TCB0 interrupt is stopped for sleep, and the time slept is caught up from the RTC count
+    
+    //CPU cycles per us
+#define TIMEBASE_CYCLES_PER_US (F_CPU / 1000000UL)
+    
+    //Called from the TCB0 interrupt at the start of each period (5 ms)
+    typedef void (*TIMEBASE_TICK_CALLBACK_t)(void);
+    
+    //Start the clock from 0
+    void Timebase_Initialize(void);
+    
+    //Set the function called on each period of TCB0 (NULL for none)
+    void Timebase_TickCallbackRegister(TIMEBASE_TICK_CALLBACK_t callback);
+    
+    //Stop the TCB0 interrupt, so it does not wake the CPU - only call with interrupts disabled, before sleeping
+    //Does nothing while the RTC overflow interrupt is off, as the time slept could not be caught up
+    //The next read of the time (or Timebase_Resume) catches up the time slept from the RTC
+    void Timebase_Suspend(void);
+    
+    //Catch up the time and restart the TCB0 interrupt - call after waking, and first in the RTC overflow interrupt
+    void Timebase_Resume(void);
+    
+    //Returns the time (us) - safe to call from interrupts
+    uint32_t Timebase_GetMicros(void);
+    
+    //Returns the time (us) - only call with interrupts disabled (e.g. at the start of an ISR)
+    uint32_t Timebase_GetMicrosFromISR(void);
+    
+    //Returns a CPU cycle count, with the resolution of TCB0 (2 cycles) - only call with interrupts disabled
+    //The count wraps every 214 s, so only use it to time short sections
+    uint32_t Timebase_GetCyclesFromISR(void);
+    
+    //Returns the time (us) since start, across a wrap
+    uint32_t Timebase_Elapsed(uint32_t start);
+    
+    //Returns true once interval (us) has passed since start
+    bool Timebase_HasElapsed(uint32_t start, uint32_t interval);
+    
+    //Returns and clears the longest delay from a TCB0 restart to its interrupt (us)
+    //This includes the interrupt entry - it shows how long level 0 interrupts are held off
+    uint16_t Timebase_GetMaxLatency(void);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* TIMEBASE_H */
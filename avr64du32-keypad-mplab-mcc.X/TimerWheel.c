@@ -0,0 +1,402 @@
+#include "TimerWheel.h"
+
+#include <stddef.h>
+#include <util/atomic.h>
+
+#include "Timebase.h"
+
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+
+//Ticks covered by the wheel
+#define TIMER_WHEEL_RANGE (1UL << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS))
+
+//Slot of a timer that is not armed
+#define TIMER_WHEEL_NOT_ARMED 0xFF
+
+#if (TIMER_WHEEL_POOL_SIZE >= TIMER_WHEEL_NONE)
+#error "TIMER_WHEEL_POOL_SIZE must be less than TIMER_WHEEL_NONE"
+#endif
+
+#if ((TIMER_WHEEL_SLOTS * TIMER_WHEEL_LEVELS) > TIMER_WHEEL_NOT_ARMED)
+#error "Too many slots in the wheel"
+#endif
+
+//Timer in the pool - armed timers are in the list of a slot, free timers are in the free list
+typedef struct {
+    TIMER_WHEEL_HANDLE_t next;
+    TIMER_WHEEL_HANDLE_t prev;
+    uint32_t expires;
+    uint32_t period;
+    TIMER_WHEEL_CALLBACK_t callback;
+    uint8_t slot;
+} TIMER_WHEEL_TIMER_t;
+
+//Timer pool
+static TIMER_WHEEL_TIMER_t timers[TIMER_WHEEL_POOL_SIZE];
+
+//First timer of each slot (level * TIMER_WHEEL_SLOTS + slot)
+static TIMER_WHEEL_HANDLE_t slots[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+
+//First free timer
+static TIMER_WHEEL_HANDLE_t freeList = TIMER_WHEEL_NONE;
+
+//Ticks processed by the wheel
+static uint32_t now = 0;
+
+//Ticks counted by the interrupt, but not processed
+static volatile uint8_t pendingTicks = 0;
+
+//Timers armed (read by the tick interrupt)
+static volatile uint16_t armedCount = 0;
+
+//Statistics
+static TIMER_WHEEL_STATS_t stats;
+
+//Add a timer to the front of a slot list
+static void TimerWheel_link(TIMER_WHEEL_HANDLE_t timer, uint8_t slot)
+{
+    TIMER_WHEEL_HANDLE_t first = slots[slot];
+    
+    timers[timer].slot = slot;
+    timers[timer].prev = TIMER_WHEEL_NONE;
+    timers[timer].next = first;
+    
+    if (first != TIMER_WHEEL_NONE)
+    {
+        timers[first].prev = timer;
+    }
+    slots[slot] = timer;
+}
+
+//Remove a timer from its slot list
+static void TimerWheel_unlink(TIMER_WHEEL_HANDLE_t timer)
+{
+    TIMER_WHEEL_TIMER_t* entry = &timers[timer];
+    
+    if (entry->prev != TIMER_WHEEL_NONE)
+    {
+        timers[entry->prev].next = entry->next;
+    }
+    else
+    {
+        slots[entry->slot] = entry->next;
+    }
+    
+    if (entry->next != TIMER_WHEEL_NONE)
+    {
+        timers[entry->next].prev = entry->prev;
+    }
+    
+    entry->slot = TIMER_WHEEL_NOT_ARMED;
+}
+
+//Put a timer in the slot for its expiry time
+static void TimerWheel_insert(TIMER_WHEEL_HANDLE_t timer)
+{
+    uint32_t expires = timers[timer].expires;
+    uint32_t delta = expires - now;
+    uint8_t level = 0;
+    
+    //Find the first level that covers the delta
+    while ((level < (TIMER_WHEEL_LEVELS - 1)) && (delta >= (1UL << (TIMER_WHEEL_SLOT_BITS * (level + 1)))))
+    {
+        level++;
+    }
+    
+    if (delta >= TIMER_WHEEL_RANGE)
+    {
+        //Out of range - wait in the last slot of the top level to cascade, then try again
+        expires = now + TIMER_WHEEL_RANGE - 1;
+    }
+    
+    uint8_t slot = (expires >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+    TimerWheel_link(timer, (level * TIMER_WHEEL_SLOTS) + slot);
+}
+
+//Move the timers of a slot down to the lower levels
+static void TimerWheel_cascade(uint8_t level)
+{
+    uint8_t slot = (level * TIMER_WHEEL_SLOTS) + ((now >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK);
+    TIMER_WHEEL_HANDLE_t timer = slots[slot];
+    
+    slots[slot] = TIMER_WHEEL_NONE;
+    
+    while (timer != TIMER_WHEEL_NONE)
+    {
+        TIMER_WHEEL_HANDLE_t next = timers[timer].next;
+        
+        TimerWheel_insert(timer);
+        timer = next;
+    }
+}
+
+//Convert ms into ticks, at least 1
+static uint32_t TimerWheel_toTicks(uint32_t time)
+{
+    time = (time + TIMER_WHEEL_TICK_MS - 1) / TIMER_WHEEL_TICK_MS;
+    
+    if (time == 0)
+    {
+        time = 1;
+    }
+    
+    return time;
+}
+
+//Advance the wheel by a tick, and run the expired timers
+static void TimerWheel_advance(void)
+{
+    uint8_t slot;
+    TIMER_WHEEL_HANDLE_t timer;
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        now++;
+        
+        //Cascade from the top level down, at the wrap of each lower level
+        for (uint8_t level = TIMER_WHEEL_LEVELS - 1; level > 0; level--)
+        {
+            uint32_t mask = (1UL << (TIMER_WHEEL_SLOT_BITS * level)) - 1;
+            
+            if ((now & mask) == 0)
+            {
+                TimerWheel_cascade(level);
+            }
+        }
+        
+        slot = now & TIMER_WHEEL_SLOT_MASK;
+    }
+    
+    //Run each expired timer - callbacks may arm or cancel any timer, so take one at a time
+    while (true)
+    {
+        TIMER_WHEEL_CALLBACK_t callback = NULL;
+        
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            timer = slots[slot];
+            
+            if (timer != TIMER_WHEEL_NONE)
+            {
+                TimerWheel_unlink(timer);
+                callback = timers[timer].callback;
+                stats.expired++;
+                
+                if (timers[timer].period != 0)
+                {
+                    //Periodic - rearm from the expiry time, so the period does not drift
+                    timers[timer].expires += timers[timer].period;
+                    TimerWheel_insert(timer);
+                }
+                else
+                {
+                    armedCount--;
+                }
+            }
+        }
+        
+        if (timer == TIMER_WHEEL_NONE)
+        {
+            break;
+        }
+        
+        if (callback != NULL)
+        {
+            callback(timer);
+        }
+    }
+}
+
+//Empty the wheel, and put all timers in the pool
+void TimerWheel_Initialize(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        for (uint8_t i = 0; i < (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS); i++)
+        {
+            slots[i] = TIMER_WHEEL_NONE;
+        }
+        
+        for (TIMER_WHEEL_HANDLE_t i = 0; i < TIMER_WHEEL_POOL_SIZE; i++)
+        {
+            timers[i].next = i + 1;
+            timers[i].slot = TIMER_WHEEL_NOT_ARMED;
+        }
+        timers[TIMER_WHEEL_POOL_SIZE - 1].next = TIMER_WHEEL_NONE;
+        
+        freeList = 0;
+        now = 0;
+        pendingTicks = 0;
+        armedCount = 0;
+        
+        stats.ticks = 0;
+        stats.expired = 0;
+        stats.maxArmed = 0;
+        stats.maxTickTime = 0;
+        stats.armedAtMaxTick = 0;
+    }
+}
+
+//Take a timer from the pool
+TIMER_WHEEL_HANDLE_t TimerWheel_Create(TIMER_WHEEL_CALLBACK_t callback)
+{
+    TIMER_WHEEL_HANDLE_t timer;
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        timer = freeList;
+        
+        if (timer != TIMER_WHEEL_NONE)
+        {
+            freeList = timers[timer].next;
+            
+            timers[timer].callback = callback;
+            timers[timer].slot = TIMER_WHEEL_NOT_ARMED;
+            timers[timer].period = 0;
+        }
+    }
+    
+    return timer;
+}
+
+//Cancel a timer and return it to the pool
+void TimerWheel_Delete(TIMER_WHEEL_HANDLE_t timer)
+{
+    if (timer >= TIMER_WHEEL_POOL_SIZE)
+    {
+        return;
+    }
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        TimerWheel_Cancel(timer);
+        
+        timers[timer].callback = NULL;
+        timers[timer].next = freeList;
+        freeList = timer;
+    }
+}
+
+//Start (or restart) a timer
+void TimerWheel_Arm(TIMER_WHEEL_HANDLE_t timer, uint32_t delay, uint32_t period)
+{
+    if (timer >= TIMER_WHEEL_POOL_SIZE)
+    {
+        return;
+    }
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        TimerWheel_Cancel(timer);
+        
+        timers[timer].expires = now + TimerWheel_toTicks(delay);
+        timers[timer].period = (period == 0) ? 0 : TimerWheel_toTicks(period);
+        TimerWheel_insert(timer);
+        
+        armedCount++;
+        if (armedCount > stats.maxArmed)
+        {
+            stats.maxArmed = armedCount;
+        }
+    }
+}
+
+//Stop a timer
+void TimerWheel_Cancel(TIMER_WHEEL_HANDLE_t timer)
+{
+    if (timer >= TIMER_WHEEL_POOL_SIZE)
+    {
+        return;
+    }
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (timers[timer].slot != TIMER_WHEEL_NOT_ARMED)
+        {
+            TimerWheel_unlink(timer);
+            armedCount--;
+        }
+    }
+}
+
+//Returns true if the timer is armed
+bool TimerWheel_IsArmed(TIMER_WHEEL_HANDLE_t timer)
+{
+    if (timer >= TIMER_WHEEL_POOL_SIZE)
+    {
+        return false;
+    }
+    
+    return (timers[timer].slot != TIMER_WHEEL_NOT_ARMED);
+}
+
+//Call from the tick interrupt
+void TimerWheel_Tick(void)
+{
+    if (pendingTicks < UINT8_MAX)
+    {
+        pendingTicks++;
+    }
+}
+
+//Returns true if ticks are waiting for TimerWheel_Service
+bool TimerWheel_IsPending(void)
+{
+    return (pendingTicks != 0);
+}
+
+//Returns true if no timer is armed and no ticks are waiting
+bool TimerWheel_IsIdle(void)
+{
+    bool isIdle;
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        isIdle = ((armedCount == 0) && (pendingTicks == 0));
+    }
+    
+    return isIdle;
+}
+
+//Process the ticks and run the callbacks of the expired timers
+void TimerWheel_Service(void)
+{
+    while (pendingTicks != 0)
+    {
+        uint16_t armed = armedCount;
+        uint32_t start = Timebase_GetMicros();
+        
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            pendingTicks--;
+        }
+        
+        TimerWheel_advance();
+        
+        //Tick cost against the number of timers armed
+        uint32_t time = Timebase_Elapsed(start);
+        
+        stats.ticks++;
+        if (time > stats.maxTickTime)
+        {
+            stats.maxTickTime = (time > UINT16_MAX) ? UINT16_MAX : time;
+            stats.armedAtMaxTick = armed;
+        }
+    }
+}
+
+//Copy and clear the statistics
+void TimerWheel_GetStats(TIMER_WHEEL_STATS_t* copy)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *copy = stats;
+        
+        stats.ticks = 0;
+        stats.expired = 0;
+        stats.maxArmed = armedCount;
+        stats.maxTickTime = 0;
+        stats.armedAtMaxTick = 0;
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef TIMERWHEEL_H
+#define	TIMERWHEEL_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+    //Length of a tick (ms) - the TCB0 period of the timebase
+#define TIMER_WHEEL_TICK_MS 5
+    
+    //Number of timers in the pool (up to 65534)
+    //Each timer takes 15 bytes of RAM, so 32 take 480 of the 8 KB, and 256 would take 3840
+    //The firmware arms 2 (macro playback and the statistics log) - the log shows the most armed at once
+    //Arm, cancel and tick costs do not depend on the pool size, so it can be raised for more timers
+#define TIMER_WHEEL_POOL_SIZE 32
+    
+    //Slots per level (power of 2) - 3 levels of 32 slots cover 32768 ticks (163 s)
+    //Longer timers wait in the last level until they are in range
+#define TIMER_WHEEL_SLOT_BITS 5
+#define TIMER_WHEEL_LEVELS 3
+    
+    //Handle returned when no timer is free
+#define TIMER_WHEEL_NONE 0xFFFF
+    
+    //Handle of a timer in the pool
+    typedef uint16_t TIMER_WHEEL_HANDLE_t;
+    
+    //Called from TimerWheel_Service when a timer expires
+    typedef void (*TIMER_WHEEL_CALLBACK_t)(TIMER_WHEEL_HANDLE_t timer);
+    
+    //Timer wheel statistics
+    typedef struct {
+        //Ticks processed
+        uint16_t ticks;
+        
+        //Timers expired
+        uint16_t expired;
+        
+        //Most timers armed at once
+        uint16_t maxArmed;
+        
+        //Longest tick, including the callbacks (us), and the timers armed at the start of it
+        uint16_t maxTickTime;
+        uint16_t armedAtMaxTick;
+    } TIMER_WHEEL_STATS_t;
+    
+    //Empty the wheel, and put all timers in the pool
+    void TimerWheel_Initialize(void);
+    
+    //Take a timer from the pool
+    //Returns TIMER_WHEEL_NONE if the pool is empty
+    TIMER_WHEEL_HANDLE_t TimerWheel_Create(TIMER_WHEEL_CALLBACK_t callback);
+    
+    //Cancel a timer and return it to the pool
+    void TimerWheel_Delete(TIMER_WHEEL_HANDLE_t timer);
+    
+    //Start (or restart) a timer - delay and period are in ms, a period of 0 is a one-shot timer
+    void TimerWheel_Arm(TIMER_WHEEL_HANDLE_t timer, uint32_t delay, uint32_t period);
+    
+    //Stop a timer - it can be armed again
+    void TimerWheel_Cancel(TIMER_WHEEL_HANDLE_t timer);
+    
+    //Returns true if the timer is armed
+    bool TimerWheel_IsArmed(TIMER_WHEEL_HANDLE_t timer);
+    
+    //Call from the tick interrupt - counts a tick for TimerWheel_Service
+    void TimerWheel_Tick(void);
+    
+    //Returns true if ticks are waiting for TimerWheel_Service
+    bool TimerWheel_IsPending(void);
+    
+    //Returns true if no timer is armed and no ticks are waiting - the tick is not needed
+    bool TimerWheel_IsIdle(void);
+    
+    //Process the ticks and run the callbacks of the expired timers - call from the main loop
+    void TimerWheel_Service(void);
+    
+    //Copy and clear the statistics
+    void TimerWheel_GetStats(TIMER_WHEEL_STATS_t* stats);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* TIMERWHEEL_H */
@@ -0,0 +1,273 @@
+#include "USBRecovery.h"
+
+#include "usb_core.h"
+#include "usb_core_transfer.h"
+#include "usb_peripheral.h"
+#include "mcc_generated_files/usb/usb_device.h"
+#include "Timebase.h"
+
+//Stage currently being executed
+static volatile USB_RECOVERY_STAGE stage = USB_RECOVERY_IDLE;
+
+//Stage to start from on the next failure
+static USB_RECOVERY_STAGE nextStage = USB_RECOVERY_ABORT_PIPES;
+
+//Current backoff between stages, in ms
+static uint16_t backoffPeriod = USB_RECOVERY_BACKOFF_MIN_MS;
+
+//Set while the device is detached during a re-enumeration
+static bool isDetached = false;
+
+//The next stage can run once the wait (ms) has passed since waitStart (us)
+static uint32_t waitStart = 0;
+static uint16_t waitTime = 0;
+
+//Time the recovery started (us)
+static uint32_t startTime = 0;
+
+//Time of the last successful recovery (us), if any
+static uint32_t recoveredTime = 0;
+static bool hasRecovered = false;
+
+//Result of the last recovery
+static USB_RECOVERY_STAGE lastStage = USB_RECOVERY_IDLE;
+static uint32_t lastDuration = 0;
+
+//Abort every transfer, then restart the control endpoint
+static RETURN_CODE_t USBRecovery_AbortPipes(void)
+{
+    RETURN_CODE_t status = SUCCESS;
+    
+    USB_PIPE_t pipe = { .address = 0 };
+    while (pipe.address < USB_EP_NUM)
+    {
+        if (status == SUCCESS)
+        {
+            pipe.direction = USB_EP_DIR_OUT;
+            status = USB_TransferAbort(pipe);
+        }
+        if (status == SUCCESS)
+        {
+            pipe.direction = USB_EP_DIR_IN;
+            status = USB_TransferAbort(pipe);
+        }
+        pipe.address++;
+    }
+    
+    if (status == SUCCESS)
+    {
+        status = USB_ControlTransferReset();
+    }
+    
+    return status;
+}
+
+//Reset every pipe and reconfigure the control endpoints
+static RETURN_CODE_t USBRecovery_RearmEndpoints(void)
+{
+    RETURN_CODE_t status = USBRecovery_AbortPipes();
+    
+    USB_PIPE_t pipe = { .address = 0 };
+    while (pipe.address < USB_EP_NUM)
+    {
+        if (status == SUCCESS)
+        {
+            pipe.direction = USB_EP_DIR_OUT;
+            status = USB_PipeReset(pipe);
+        }
+        if (status == SUCCESS)
+        {
+            pipe.direction = USB_EP_DIR_IN;
+            status = USB_PipeReset(pipe);
+        }
+        pipe.address++;
+    }
+    
+    if (status == SUCCESS)
+    {
+        status = USB_ControlEndpointsInit();
+    }
+    
+    if (status == SUCCESS)
+    {
+        status = USB_ControlTransferReset();
+    }
+    
+    return status;
+}
+
+//Wait time (ms) from now before the next stage runs
+static void USBRecovery_wait(uint16_t time)
+{
+    waitStart = Timebase_GetMicros();
+    waitTime = time;
+}
+
+//Detach from the bus, wait for the host to notice, then attach again
+static RETURN_CODE_t USBRecovery_Reenumerate(void)
+{
+    RETURN_CODE_t status = UNINITIALIZED;
+    
+    if (!isDetached)
+    {
+        //Errors while stopping are ignored, the peripheral is restarted anyway
+        (void) USB_Stop();
+        isDetached = true;
+        USBRecovery_wait(USB_RECOVERY_DETACH_MS);
+        
+        //Not done yet
+        status = UNINITIALIZED;
+    }
+    else
+    {
+        isDetached = false;
+        status = USB_Start();
+    }
+    
+    return status;
+}
+
+//Clear the recovery history (e.g. when VBUS is removed)
+void USBRecovery_Reset(void)
+{
+    stage = USB_RECOVERY_IDLE;
+    nextStage = USB_RECOVERY_ABORT_PIPES;
+    backoffPeriod = USB_RECOVERY_BACKOFF_MIN_MS;
+    isDetached = false;
+    waitTime = 0;
+    hasRecovered = false;
+}
+
+//Start recovering from a USB failure
+void USBRecovery_Start(USB_RECOVERY_STAGE firstStage)
+{
+    //Already recovering
+    if (stage != USB_RECOVERY_IDLE)
+        return;
+    
+    startTime = Timebase_GetMicros();
+    
+    //First attempt runs immediately
+    waitTime = 0;
+    
+    //The last recovery held up, start again from the cheapest stage
+    //(The clock wraps every 71 minutes, so a rare failure long after a recovery may still escalate)
+    if ((!hasRecovered) || (Timebase_HasElapsed(recoveredTime, (uint32_t) USB_RECOVERY_PROBATION_MS * 1000)))
+    {
+        nextStage = USB_RECOVERY_ABORT_PIPES;
+        backoffPeriod = USB_RECOVERY_BACKOFF_MIN_MS;
+    }
+    
+    stage = (nextStage > firstStage) ? nextStage : firstStage;
+}
+
+//Run the current recovery stage once its backoff has expired
+bool USBRecovery_Service(void)
+{
+    if (stage == USB_RECOVERY_IDLE)
+    {
+        return true;
+    }
+    
+    if (!Timebase_HasElapsed(waitStart, (uint32_t) waitTime * 1000))
+    {
+        return false;
+    }
+    
+    RETURN_CODE_t status = UNINITIALIZED;
+    
+    switch (stage)
+    {
+        case USB_RECOVERY_ABORT_PIPES:
+        {
+            status = USBRecovery_AbortPipes();
+            break;
+        }
+        case USB_RECOVERY_REARM_ENDPOINTS:
+        {
+            status = USBRecovery_RearmEndpoints();
+            break;
+        }
+        case USB_RECOVERY_REINIT_PERIPHERAL:
+        {
+            status = USB_Reset();
+            break;
+        }
+        case USB_RECOVERY_REENUMERATE:
+        {
+            status = USBRecovery_Reenumerate();
+            
+            //Still detached
+            if (isDetached)
+            {
+                return false;
+            }
+            break;
+        }
+        default:
+        {
+            //We shouldn't get here
+            status = UNINITIALIZED;
+        }
+    }
+    
+    if (status == SUCCESS)
+    {
+        //Record the result
+        recoveredTime = Timebase_GetMicros();
+        hasRecovered = true;
+        lastStage = stage;
+        lastDuration = (recoveredTime - startTime) / 1000;
+        
+        //If this does not hold, escalate on the next failure
+        if (stage < USB_RECOVERY_REENUMERATE)
+        {
+            nextStage = stage + 1;
+        }
+        else
+        {
+            nextStage = USB_RECOVERY_REENUMERATE;
+        }
+        
+        stage = USB_RECOVERY_IDLE;
+        USBDevice_StatusClear();
+        return true;
+    }
+    
+    //Stage failed - escalate (re-enumeration is repeated until it succeeds)
+    if (stage < USB_RECOVERY_REENUMERATE)
+    {
+        stage++;
+    }
+    
+    USBRecovery_wait(backoffPeriod);
+    
+    if (backoffPeriod < (USB_RECOVERY_BACKOFF_MAX_MS / 2))
+    {
+        backoffPeriod *= 2;
+    }
+    else
+    {
+        backoffPeriod = USB_RECOVERY_BACKOFF_MAX_MS;
+    }
+    
+    return false;
+}
+
+//Returns true while a recovery is in progress
+bool USBRecovery_IsActive(void)
+{
+    return (stage != USB_RECOVERY_IDLE);
+}
+
+//Returns the stage that completed the last recovery
+USB_RECOVERY_STAGE USBRecovery_GetLastStage(void)
+{
+    return lastStage;
+}
+
+//Returns the duration of the last recovery, in ms
+uint32_t USBRecovery_GetLastDuration(void)
+{
+    return lastDuration;
+}
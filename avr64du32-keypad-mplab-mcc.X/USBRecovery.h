@@ -0,0 +1,56 @@
+#ifndef USBRECOVERY_H
+#define	USBRECOVERY_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdint.h>
+#include <stdbool.h>
+    
+    //Times are measured with the timebase (Timebase_GetMicros)
+    //The USB task checks them each time it runs - the RTC wakes it every 5 ms during a recovery
+    
+    //Backoff after the first failed stage, in ms (doubles on every failure)
+#define USB_RECOVERY_BACKOFF_MIN_MS 10
+    
+    //Upper limit of the backoff, in ms
+#define USB_RECOVERY_BACKOFF_MAX_MS 1000
+    
+    //How long the device stays detached during a re-enumeration, in ms
+#define USB_RECOVERY_DETACH_MS 100
+    
+    //A failure within this many ms of a recovery escalates to the next stage
+#define USB_RECOVERY_PROBATION_MS 1000
+    
+    typedef enum {
+        USB_RECOVERY_IDLE = 0, USB_RECOVERY_ABORT_PIPES, USB_RECOVERY_REARM_ENDPOINTS,
+                USB_RECOVERY_REINIT_PERIPHERAL, USB_RECOVERY_REENUMERATE
+    } USB_RECOVERY_STAGE;
+    
+    //Clear the recovery history (e.g. when VBUS is removed)
+    void USBRecovery_Reset(void);
+    
+    //Start recovering from a USB failure, beginning no earlier than firstStage
+    //If the last recovery failed within the probation window, the next stage is used
+    void USBRecovery_Start(USB_RECOVERY_STAGE firstStage);
+    
+    //Run the current recovery stage once its backoff has expired
+    //Returns true when the USB stack has been recovered
+    bool USBRecovery_Service(void);
+    
+    //Returns true while a recovery is in progress
+    bool USBRecovery_IsActive(void);
+    
+    //Returns the stage that completed the last recovery
+    USB_RECOVERY_STAGE USBRecovery_GetLastStage(void);
+    
+    //Returns the duration of the last recovery, in ms
+    uint32_t USBRecovery_GetLastDuration(void);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* USBRECOVERY_H */
+
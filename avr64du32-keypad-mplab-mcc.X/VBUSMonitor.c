@@ -0,0 +1,60 @@
+#include "VBUSMonitor.h"
+
+#include <util/atomic.h>
+
+#include "mcc_generated_files/ac/ac0.h"
+#include "IsrTiming.h"
+
+//Current VBUS state, updated by the AC0 interrupt
+static volatile bool isPresent = false;
+
+//Set on every VBUS edge, cleared by VBUSMonitor_HasChanged
+static volatile bool hasChanged = false;
+
+//Called by the AC0 interrupt when the comparator output toggles
+static void VBUSMonitor_onEdge(void)
+{
+    uint32_t start = IsrTiming_Start();
+    
+    //The comparator hysteresis filters noise around the threshold
+    bool present = AC0_Read();
+    
+    if (present != isPresent)
+    {
+        isPresent = present;
+        hasChanged = true;
+    }
+    
+    IsrTiming_End(ISR_TIMING_AC0, start);
+}
+
+//Register the AC0 callback and sample the initial VBUS state
+void VBUSMonitor_Initialize(void)
+{
+    isPresent = AC0_Read();
+    
+    //Report the initial state as a change so it gets handled
+    hasChanged = true;
+    
+    AC0_CallbackRegister(&VBUSMonitor_onEdge);
+}
+
+//Returns true if VBUS is present
+bool VBUSMonitor_IsPresent(void)
+{
+    return isPresent;
+}
+
+//Returns true (once) if VBUS was connected or removed since the last call
+bool VBUSMonitor_HasChanged(void)
+{
+    bool changed;
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        changed = hasChanged;
+        hasChanged = false;
+    }
+    
+    return changed;
+}
@@ -0,0 +1,24 @@
+#ifndef VBUSMONITOR_H
+#define	VBUSMONITOR_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+    
+#include <stdbool.h>
+    
+    //Register the AC0 callback and sample the initial VBUS state
+    void VBUSMonitor_Initialize(void);
+    
+    //Returns true if VBUS is present
+    bool VBUSMonitor_IsPresent(void);
+    
+    //Returns true (once) if VBUS was connected or removed since the last call
+    bool VBUSMonitor_HasChanged(void);
+    
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* VBUSMONITOR_H */
+
@@ -39,151 +39,210 @@
 #include "mcc_generated_files/usb/usb_hid/usb_hid_keyboard.h"
 #include "usb_hid_transfer.h"
 #include "KeyReporting.h"
+#include "USBRecovery.h"
+#include "VBUSMonitor.h"
+#include "SleepManager.h"
+#include "ScanRate.h"
+#include "ScanLatency.h"
+#include "KeyMatrix.h"
+#include "ButtonScan.h"
+#include "AnalogKeys.h"
+#include "Keymap.h"
+#include "KeymapFeature.h"
+#include "KeyEngine.h"
+#include "Combo.h"
+#include "KeyEventQueue.h"
+#include "KeySampleQueue.h"
+#include "Timebase.h"
+#include "TimerWheel.h"
+#include "Scheduler.h"
+#include "IsrTiming.h"
+#include "PinCapture.h"
+#include "Macro.h"
+
+#include <util/atomic.h>
 
 typedef enum {
-    APPLICATION_USB_ERROR = -1, APPLICATION_USB_NOT_INIT,
-            APPLICATION_USB_INIT
+    APPLICATION_USB_NOT_INIT = 0, APPLICATION_USB_INIT, APPLICATION_USB_RECOVERY
 } APPLICATION_USB_STATE;
 
+//Scheduler tasks - lower numbers run first
 typedef enum {
-    NOT_PRESSED = 0, PRESSED, HELD_WAIT
-} APPLICATION_KEY_STATE;
+    APPLICATION_TASK_USB = 0, APPLICATION_TASK_KEYS, APPLICATION_TASK_TIMERS, APPLICATION_TASK_EEPROM, APPLICATION_TASK_LOG
+} APPLICATION_TASK;
 
-//Number of tries to re-init the USB
-#define USB_INIT_RETRIES 10
+//If set, the firmware statistics and the CPU use of each task are printed every STATS_LOG_PERIOD ms
+//#define STATS_LOG_ENABLE
 
-//Where are the buttons in the array
-#define SW0_INDEX 0
-#define BUTTON1_INDEX 1
-#define BUTTON2_INDEX 2
-#define BUTTON3_INDEX 3
-#define BUTTON4_INDEX 4
+//Time between statistics logs (ms)
+#define STATS_LOG_PERIOD 10000
 
-#define COPY_BUTTON_INDEX BUTTON1_INDEX
-#define PASTE_BUTTON_INDEX BUTTON2_INDEX
-#define UNDO_BUTTON_INDEX BUTTON3_INDEX
-#define CUT_BUTTON_INDEX BUTTON4_INDEX
+//If set, a key matrix is scanned as well as the buttons (see KeyMatrix.h for the pins)
+//#define KEY_MATRIX_ENABLE
 
-//If set, the external button is NC, not NO
-//#define EXTERNAL_BUTTON_NC
+//If set, analog Hall-effect keys are scanned as well as the buttons (see AnalogKeys.h)
+//#define ANALOG_KEYS_ENABLE
 
-//Should a key packet be sent?
-static volatile bool shouldSendKeyEvent = false;
+//If set, keys are scanned on USB Start-of-Frame instead of the RTC while the host is sending SOFs
+//#define KEY_SCAN_SOF_ALIGNED
 
-//Current State of the keys
-static volatile APPLICATION_KEY_STATE keyStates[USB_HID_KEYBOARD_REPORT_KEYNUM] = 
-{ NOT_PRESSED, NOT_PRESSED, NOT_PRESSED, NOT_PRESSED, NOT_PRESSED, NOT_PRESSED};
+//Frames (1 ms) between SOF aligned scans - this also debounces the keys
+#define KEY_SCAN_SOF_INTERVAL 5
 
-static volatile APPLICATION_KEY_STATE state = NOT_PRESSED;
+//Time from the SOF to the scan (us, up to 999), on every KEY_SCAN_SOF_INTERVAL frames
+#define KEY_SCAN_SOF_OFFSET 0
 
-//USB Keyboard Report
-static volatile USB_KEYBOARD_REPORT_DATA_t keyReport;
+#if (KEY_SCAN_SOF_OFFSET >= 1000)
+#error "KEY_SCAN_SOF_OFFSET must be within the frame"
+#endif
 
-void onRTC_Overflow(void)
+//If set, the level 0 interrupts take turns, instead of USB0 bus events first
+//USB0 transaction complete stays at level 1
+//#define INTERRUPT_ROUND_ROBIN
+
+//USB Bus State
+static APPLICATION_USB_STATE usbState = APPLICATION_USB_NOT_INIT;
+
+#ifdef KEY_MATRIX_ENABLE
+//Key sent for each matrix position (3 x 7 layout)
+static const uint8_t matrixKeymap[KEY_MATRIX_ROWS][KEY_MATRIX_COLS] = 
 {
-    //If VBUS is not present, reset state machine
-    if (!AC0_Read())
-    {
-        state = NOT_PRESSED;
-        return;
-    }
+    { HID_ESCAPE, HID_1, HID_2, HID_3, HID_4, HID_5, HID_6 },
+    { HID_TAB, HID_Q, HID_W, HID_E, HID_R, HID_T, HID_Y },
+    { HID_CAPS_LOCK, HID_A, HID_S, HID_D, HID_F, HID_G, HID_H }
+};
 
-    //State machine
-    switch (state)
+//Has the matrix key been sent? (Cleared when the matrix is released)
+static bool isMatrixHeld = false;
+#endif
+
+#ifdef KEY_SCAN_SOF_ALIGNED
+//Is the host sending SOFs? (Cleared by the RTC)
+static volatile bool isSOFActive = false;
+#endif
+
+//Top half - sample the keys and pass them to the key task
+static void sampleKeys(SCAN_LATENCY_SOURCE source)
+{
+    KEY_SAMPLE_t sample;
+    
+    sample.time = Timebase_GetMicrosFromISR();
+    sample.source = source;
+    
+#ifdef KEY_MATRIX_ENABLE
+    KeyMatrix_Scan();
+#endif
+    
+    //Sample all buttons at once
+    uint8_t buttons = ButtonScan_Update();
+    PinCapture_Scan(ButtonScan_GetSample());
+    
+#ifdef ANALOG_KEYS_ENABLE
+    //The key task collects the conversions
+    AnalogKeys_Start();
+#endif
+    
+    //Keymap keys - the key task adds the analog keys
+    sample.keys = buttons;
+    
+    //Matrix - the first key pressed
+    sample.matrixKey = HID_KEY_NONE;
+    sample.isMatrixIdle = true;
+#ifdef KEY_MATRIX_ENABLE
+    uint8_t row, col;
+    
+    if (!KeyMatrix_IsIdle())
     {
-        case NOT_PRESSED:
+        sample.isMatrixIdle = false;
+        
+        if (KeyMatrix_GetFirstPressed(&row, &col))
         {
-            
-            //Assume a key was pressed (variable cleared if not pressed)
-            shouldSendKeyEvent = true;
-            
-            if (SW0_GetValue())
-            {
-                //SW0 - Print "AVR DU"
-                KeyReport_addKeyDownEventFromChar(&keyReport, 'A');
-                KeyReport_addKeyDownEventFromChar(&keyReport, 'V');
-                KeyReport_addKeyDownEventFromChar(&keyReport, 'R');
-                KeyReport_addKeyDownEventFromChar(&keyReport, ' ');
-                KeyReport_addKeyDownEventFromChar(&keyReport, 'D');
-                KeyReport_addKeyDownEventFromChar(&keyReport, 'U');
-            }
-            
-#ifndef EXTERNAL_BUTTON_NC
-            else if (!BUTTON_EXTERNAL_GetValue())
-#else
-            else if (BUTTON_EXTERNAL_GetValue()) 
-#endif
-            {
-                //External Button - Send ALT + F4
-                KeyReport_addKeyDownEvent(&keyReport, HID_MODIFIER_LEFT_ALT, HID_F4);
-            }
-            else if (BUTTON_1_GetValue())
-            {
-                //BUTTON1 - CTRL + C
-                KeyReport_addKeyDownEvent(&keyReport, HID_MODIFIER_LEFT_CTRL, HID_C);
-            }
-            else if (BUTTON_2_GetValue())
-            {
-                //BUTTON2 - CTRL + V
-                KeyReport_addKeyDownEvent(&keyReport, HID_MODIFIER_LEFT_CTRL, HID_V);
-            }
-            else if (BUTTON_3_GetValue())
-            {
-                //BUTTON3 - CTRL + Z
-                KeyReport_addKeyDownEvent(&keyReport, HID_MODIFIER_LEFT_CTRL, HID_Z);
-            }
-            else if (BUTTON_4_GetValue())
-            {
-                //BUTTON4 - CTRL + X
-                KeyReport_addKeyDownEvent(&keyReport, HID_MODIFIER_LEFT_CTRL, HID_X);
-            }
-            else
-            {
-                //No key was pressed
-                shouldSendKeyEvent = false;
-            }
-            
-            //Transition to the PRESSED event
-            if (shouldSendKeyEvent)
-                state = PRESSED;
-            
-            break;
+            sample.matrixKey = matrixKeymap[row][col];
         }
-        case PRESSED:
+    }
+#endif
+    
+    if (KeySampleQueue_Push(&sample))
+    {
+        Scheduler_Post(APPLICATION_TASK_KEYS);
+    }
+}
+
+void onRTC_Overflow(void)
+{
+    //Catch up the time slept before the scan rate can change the RTC period
+    Timebase_Resume();
+    uint32_t start = IsrTiming_Start();
+    
+    SleepManager_Tick();
+    Keymap_Tick();
+    
+    //Sample the keys while VBUS is present - the USB task releases them when it is removed
+    if (VBUSMonitor_IsPresent())
+    {
+#ifdef KEY_SCAN_SOF_ALIGNED
+        if (isSOFActive)
         {
-            //Remove the key down events
-            KeyReport_clearReport(&keyReport);
-            shouldSendKeyEvent = true;
-            
-            //Move to the wait state
-            state = HELD_WAIT;
-            break;
+            //Keys are scanned on SOF - check the SOFs are still coming
+            isSOFActive = false;
         }
-        case HELD_WAIT:
-        {
-            //If all buttons are released, reset to NOT_PRESSED
-            if ((!BUTTON_1_GetValue()) && (!BUTTON_2_GetValue())
-                    && (!BUTTON_3_GetValue()) && (!BUTTON_4_GetValue())
-                    && (!SW0_GetValue()))
-            {
-#ifdef EXTERNAL_BUTTON_NC
-                if (!BUTTON_EXTERNAL_GetValue())
-#else
-                if (BUTTON_EXTERNAL_GetValue())
+        else
 #endif
-                {
-                    state = NOT_PRESSED;
-                }
-            }
-            break;
-        }
-        default:
         {
-            //We shouldn't get here
+            sampleKeys(SCAN_LATENCY_FREE_RUNNING);
         }
     }
+    
+    //Scan faster while keys are in use
+    ScanRate_Update((KeyEngine_IsActive()) || (Combo_IsActive()) || (USBRecovery_IsActive()) || (Keymap_IsBusy()) 
+            || (PinCapture_IsActive()));
+    
+    //Keymap or macro changes are due to be written
+    if ((Keymap_IsBusy()) || (Macro_IsBusy()))
+    {
+        Scheduler_Post(APPLICATION_TASK_EEPROM);
+    }
+    
+    IsrTiming_End(ISR_TIMING_RTC, start);
 }
 
+//Timebase tick - count it for the software timers
+void onTimebaseTick(void)
+{
+    //The timers task only runs while a timer is armed
+    if (!TimerWheel_IsIdle())
+    {
+        TimerWheel_Tick();
+        Scheduler_Post(APPLICATION_TASK_TIMERS);
+    }
+}
+
+#ifdef KEY_SCAN_SOF_ALIGNED
+//Start the scan timer on the scan frames, so the report is ready for the IN token
+void onUSB_SOF(void)
+{
+    isSOFActive = true;
+    
+    if ((USB_FrameNumberGet() % KEY_SCAN_SOF_INTERVAL) == 0)
+    {
+        TCB1_TimeoutStart(KEY_SCAN_SOF_OFFSET * TCB1_COUNTS_PER_US);
+    }
+}
+
+//KEY_SCAN_SOF_OFFSET after the SOF - sample the keys from the TCB1 interrupt, like the RTC scan
+static void onSOFScan(void)
+{
+    uint32_t start = IsrTiming_Start();
+    
+    if (VBUSMonitor_IsPresent())
+    {
+        sampleKeys(SCAN_LATENCY_SOF_ALIGNED);
+    }
+    
+    IsrTiming_End(ISR_TIMING_TCB1, start);
+}
+#endif
+
 //Bitmask of USB Report
 #define USB_NUM_LOCK_bm (0b1 << 0)
 #define USB_CAPS_LOCK_bm (0b1 << 1)
@@ -195,129 +254,462 @@ void onRTC_Overflow(void)
 void handleUSBReport(uint16_t report)
 {
     printf("%x\r\n", report);
-
+    
     //If there is no output endpoint, CAPS LOCK/SCROLL LOCK/NUM LOCK/COMPOSE/KANA are reported here
-
+    
     //[7:5] Constants
     //[4] Kana
     //[3] Compose
     //[2] Scroll Lock
     //[1] Caps Lock
     //[0] Num Lock
-
+    
     LED0_SetLow();
-
+    
     uint8_t keyMap = report & 0xFF;
-
+    
     if (keyMap & USB_NUM_LOCK_bm)
     {
         //Num Lock
     }
-
+    
     if (keyMap & USB_CAPS_LOCK_bm)
     {
         //Caps Lock
         LED0_SetHigh();
     }
-
+    
     if (keyMap & USB_SCROLL_LOCK_bm)
     {
         //Scroll Lock
     }
-
+    
     if (keyMap & USB_COMPOSE_bm)
     {
         //Compose
     }
-
+    
     if (keyMap & USB_KANA_bm)
     {
         //Kana
     }
 }
 
+//Highest priority - start, recover and poll the USB, and send the key events
+static void usbTask(void)
+{
+    //Was VBUS connected or removed?
+    if (VBUSMonitor_HasChanged() && (!VBUSMonitor_IsPresent()))
+    {
+        //VUSB was removed
+        
+        USB_Stop();
+        usbState = APPLICATION_USB_NOT_INIT;
+        USBRecovery_Reset();
+        
+        //Release all keys
+        KeySampleQueue_Clear();
+        Combo_Reset();
+        KeyEngine_Reset();
+        KeyEventQueue_Clear();
+        
+        printf("No USB Voltage\r\n");
+    }
+    
+    //If VUSB is present
+    if (VBUSMonitor_IsPresent())
+    {    
+        //Has the USB been initialized?
+        if (usbState == APPLICATION_USB_NOT_INIT)
+        {
+            //Need to start USB
+            if (USB_Start() == SUCCESS)
+            {
+                usbState = APPLICATION_USB_INIT;
+                printf("USB Started\r\n");
+            }
+            else
+            {
+                //Failed to init, restart the peripheral with backoff
+                printf("Failed to start USB\r\n");
+                USBRecovery_Start(USB_RECOVERY_REINIT_PERIPHERAL);
+                ScanRate_Wake();
+                usbState = APPLICATION_USB_RECOVERY;
+            }
+        }
+        else if (usbState == APPLICATION_USB_RECOVERY)
+        {
+            //Try to recover from the error
+            if (USBRecovery_Service())
+            {
+                usbState = APPLICATION_USB_INIT;
+                printf("USB Recovered (Stage %u, %lu ms)\r\n", 
+                        USBRecovery_GetLastStage(), USBRecovery_GetLastDuration());
+            }
+        }
+        else
+        {
+            //USB has been initialized
+            
+            //Send the oldest key event once the last report is out
+            KEY_EVENT_t keyEvent;
+            
+            if ((!USB_HIDKeyboardReportInIsBusy()) && (KeyEventQueue_Pop(&keyEvent)))
+            {
+                USB_HIDKeyboardReportInSend(&keyEvent.report); 
+            }
+            
+            //Handle USB Events
+            if (USBDevice_Handle() != SUCCESS)
+            {
+                //Unable to handle USB Events, start recovery
+                printf("An error has occurred\r\n");
+                USBRecovery_Start(USB_RECOVERY_ABORT_PIPES);
+                ScanRate_Wake();
+                usbState = APPLICATION_USB_RECOVERY;
+            }
+        }
+    }
+    
+    //Run again while there is work waiting
+    if ((VBUSMonitor_IsPresent()) && ((usbState == APPLICATION_USB_NOT_INIT) || (!KeyEventQueue_IsEmpty())))
+    {
+        Scheduler_Post(APPLICATION_TASK_USB);
+    }
+}
+
+//Bottom half - update the key states from the next sample, and queue the reports
+static void keysTask(void)
+{
+    KEY_SAMPLE_t sample;
+    
+    if (!KeySampleQueue_Pop(&sample))
+    {
+        return;
+    }
+    
+#ifdef ANALOG_KEYS_ENABLE
+    //Analog keys follow the buttons
+    sample.keys |= ((KEY_ENGINE_KEYS_t) AnalogKeys_Scan()) << KEYMAP_ANALOG_FIRST;
+#endif
+    
+    //Combos take their keys before the keys act on their own
+    KEYMAP_ACTION_t comboAction;
+    bool isCombo = Combo_Scan(&sample.keys, &comboAction);
+    
+    //Update the tap, hold and layer state of each key
+    KeyEngine_Scan(sample.keys);
+    
+    if (isCombo)
+    {
+        KeyEngine_TapAction(comboAction);
+    }
+    
+#ifdef KEY_MATRIX_ENABLE
+    //Matrix - Send the first key pressed, once until the matrix is released
+    if (sample.isMatrixIdle)
+    {
+        isMatrixHeld = false;
+    }
+    else if ((!isMatrixHeld) && (sample.matrixKey != HID_KEY_NONE))
+    {
+        isMatrixHeld = true;
+        KeyEngine_Tap(HID_MODIFIER_NONE, sample.matrixKey);
+    }
+#endif
+    
+    //Pass the next report to the USB task - reports wait in the key engine while the queue is full,
+    //or while the macro is playing
+    USB_KEYBOARD_REPORT_DATA_t keyReport;
+    
+    if ((Macro_GetState() != MACRO_PLAYING) && (!KeyEventQueue_IsFull()) && (KeyEngine_GetReport(&keyReport)))
+    {
+        KeyEventQueue_Push(&keyReport);
+        ScanLatency_Sampled(sample.source, sample.time);
+        Macro_Record(&keyReport, sample.time);
+        Scheduler_Post(APPLICATION_TASK_USB);
+    }
+    
+    //One sample per run, so the USB is checked in between
+    if (!KeySampleQueue_IsEmpty())
+    {
+        Scheduler_Post(APPLICATION_TASK_KEYS);
+    }
+}
+
+//Run the expired software timers
+static void timersTask(void)
+{
+    TimerWheel_Service();
+    
+    //Send the reports of a playing macro
+    if (!KeyEventQueue_IsEmpty())
+    {
+        Scheduler_Post(APPLICATION_TASK_USB);
+    }
+}
+
+//Lowest priority - write keymap and macro changes to EEPROM
+static void eepromTask(void)
+{
+    //Both write one byte at a time, when the EEPROM is ready
+    bool isKeymapWriting = Keymap_Service();
+    bool isMacroWriting = Macro_Service();
+    
+    //Run again while a write is in progress
+    if ((isKeymapWriting) || (isMacroWriting))
+    {
+        Scheduler_Post(APPLICATION_TASK_EEPROM);
+    }
+}
+
+#ifdef STATS_LOG_ENABLE
+//Lowest priority - print the statistics of the firmware - each GetStats call clears what it returns
+static void logTask(void)
+{
+    //Runs, longest run and CPU use of each task
+    SCHEDULER_STATS_t stats;
+    
+    for (uint8_t task = 0; task < SCHEDULER_TASKS; task++)
+    {
+        Scheduler_GetStats(task, &stats);
+        
+        //Use in 0.01 %
+        uint32_t use = (stats.window == 0) ? 0 : ((stats.totalTime * 100) / (stats.window / 100));
+        
+        printf("Task %u: %u runs, max %u us, %lu.%02lu %%\r\n", 
+                task, stats.runs, stats.maxTime, use / 100, use % 100);
+    }
+    
+    //Longest run of each interrupt against its budget
+    ISR_TIMING_STATS_t isrStats;
+    
+    for (uint8_t isr = 0; isr < ISR_TIMING_COUNT; isr++)
+    {
+        IsrTiming_GetStats(isr, &isrStats);
+        
+        printf("ISR %u: %u runs, max %u / %u cycles, %u over\r\n", 
+                isr, isrStats.runs, isrStats.maxCycles, IsrTiming_GetBudget(isr), isrStats.overruns);
+    }
+    
+    if (IsrTiming_HasOverrun())
+    {
+        printf("ISR budget exceeded since reset\r\n");
+    }
+    
+    //Longest level 0 interrupt wait, and the wait for the key task
+    KEY_SAMPLE_QUEUE_STATS_t sampleStats;
+    KeySampleQueue_GetStats(&sampleStats);
+    
+    printf("TCB0 latency: max %u us\r\n", Timebase_GetMaxLatency());
+    printf("Samples: max depth %u, %u merged, max wait %u us\r\n", 
+            sampleStats.maxDepth, sampleStats.mergedCount, sampleStats.maxDelay);
+    
+    //Sleeps at each level, and the time spent asleep in Idle
+    SLEEP_STATS_t sleepStats;
+    SleepManager_GetStats(&sleepStats);
+    
+    uint32_t idle = (sleepStats.counts == 0) ? 0 : ((sleepStats.idleCounts * 100) / sleepStats.counts);
+    
+    printf("Sleep: %u idle, %u standby, %u power down, %lu %% asleep\r\n", 
+            sleepStats.sleepCount[SLEEP_LEVEL_IDLE], sleepStats.sleepCount[SLEEP_LEVEL_STANDBY], 
+            sleepStats.sleepCount[SLEEP_LEVEL_POWER_DOWN], idle);
+    
+    //Correction applied by the OSCHF autotune
+    printf("OSCHF tune: %d\r\n", CLOCK_TuneErrorGet());
+    
+    //Deepest key event queue, and the longest wait to be sent (frames)
+    KEY_EVENT_QUEUE_STATS_t eventStats;
+    KeyEventQueue_GetStats(&eventStats);
+    
+    printf("Events: max depth %u, %u full, max wait %u ms\r\n", 
+            eventStats.maxDepth, eventStats.fullCount, eventStats.maxDelay);
+    
+    //Keymap changes written to the EEPROM journal, and folds into a new keymap copy
+    KEYMAP_STATS_t keymapStats;
+    Keymap_GetStats(&keymapStats);
+    
+    printf("Keymap: %u journal writes, %u folds\r\n", keymapStats.journalWrites, keymapStats.compactions);
+    
+    //Scans at each rate, and the wake-ups from a key edge
+    SCAN_RATE_STATS_t scanStats;
+    ScanRate_GetStats(&scanStats);
+    printf("Scans: %u active, %u idle, %u key wakes\r\n", 
+            scanStats.activeScans, scanStats.idleScans, scanStats.keyWakes);
+    
+    //Time from key sample to report sent (SCAN_LATENCY_BIN_US bins), for free-running and SOF aligned scans
+    uint16_t bins[SCAN_LATENCY_BINS];
+    
+    for (uint8_t source = 0; source < SCAN_LATENCY_SOURCE_COUNT; source++)
+    {
+        ScanLatency_GetHistogram(source, bins);
+        
+        printf("Latency %s:", (source == SCAN_LATENCY_SOF_ALIGNED) ? "SOF" : "RTC");
+        
+        for (uint8_t i = 0; i < SCAN_LATENCY_BINS; i++)
+        {
+            printf(" %u", bins[i]);
+        }
+        
+        printf("\r\n");
+    }
+    
+    //Dual-role decisions, the worst latency each decision path added (ms), and the auto-repeats
+    KEY_ENGINE_STATS_t engineStats;
+    KeyEngine_GetStats(&engineStats);
+    
+    printf("Keys: %u taps / max %u ms, %u holds / max %u ms, %u early holds / max %u ms, %u repeats, %u lost\r\n", 
+            engineStats.taps, engineStats.maxTapLatency, engineStats.holds, engineStats.maxHoldLatency, 
+            engineStats.earlyHolds, engineStats.maxEarlyHoldLatency, engineStats.repeats, engineStats.dropped);
+    
+    //Combo resolutions and their latency (ms), and the cost of a pass over the combo table
+    COMBO_STATS_t comboStats;
+    Combo_GetStats(&comboStats);
+    
+    uint32_t comboCycles = (comboStats.passes == 0) ? 0 : (comboStats.totalCycles / comboStats.passes);
+    
+    printf("Combos: %u sent / max %u ms, %u singles / max %u ms, %u in table, pass max %u / avg %lu cycles\r\n", 
+            comboStats.combos, comboStats.maxComboLatency, comboStats.singles, comboStats.maxSingleLatency, 
+            Combo_GetCount(), comboStats.maxCycles, comboCycles);
+    
+    //Software timer ticks, and the longest tick against the timers armed
+    TIMER_WHEEL_STATS_t timerStats;
+    TimerWheel_GetStats(&timerStats);
+    
+    printf("Timers: %u ticks, %u expired, max %u armed, longest tick %u us with %u armed\r\n", 
+            timerStats.ticks, timerStats.expired, timerStats.maxArmed, timerStats.maxTickTime, 
+            timerStats.armedAtMaxTick);
+    
+#ifdef ANALOG_KEYS_ENABLE
+    //Analog key presses, and the scans from leaving the reset point to a press
+    ANALOG_KEYS_STATS_t analogStats;
+    AnalogKeys_GetStats(&analogStats);
+    
+    printf("Analog: %u presses, %u rapid, latency last %u / max %u scans\r\n", 
+            analogStats.presses, analogStats.rapidPresses, analogStats.lastLatency, analogStats.maxLatency);
+#endif
+    
+#ifdef KEY_MATRIX_ENABLE
+    //Matrix scans, and scans with ghosting
+    KEY_MATRIX_STATS_t matrixStats;
+    KeyMatrix_GetStats(&matrixStats);
+    
+    printf("Matrix: %u scans, %u ghosted\r\n", matrixStats.scans, matrixStats.ghostScans);
+#endif
+}
+
+//Post the log task from the timer
+static void onStatsLogTimer(TIMER_WHEEL_HANDLE_t timer)
+{
+    Scheduler_Post(APPLICATION_TASK_LOG);
+}
+#endif
+
 int main(void)
 {
     //Setup USB Callback
     HID_SetReportCallbackRegister(&handleUSBReport);
+#ifdef KEY_SCAN_SOF_ALIGNED
+    USB_SOFCallbackRegister(&onUSB_SOF);
+    TCB1_TimeoutCallbackRegister(&onSOFScan);
+#endif
+    ScanLatency_Initialize();
+    IsrTiming_Initialize();
+    KeySampleQueue_Initialize();
+    KeyEventQueue_Initialize();
     
     //Init HW Peripherals
     SYSTEM_Initialize();
+#ifdef INTERRUPT_ROUND_ROBIN
+    CPUINT_RoundRobinEnable();
+#endif
+    
+    //Microsecond clock, and software timers on its tick
+    Timebase_Initialize();
+    TimerWheel_Initialize();
+    Timebase_TickCallbackRegister(&onTimebaseTick);
+    
+    //Tasks, in priority order
+    Scheduler_Initialize();
+    Scheduler_AddTask(APPLICATION_TASK_USB, &usbTask);
+    Scheduler_AddTask(APPLICATION_TASK_KEYS, &keysTask);
+    Scheduler_AddTask(APPLICATION_TASK_TIMERS, &timersTask);
+    Scheduler_AddTask(APPLICATION_TASK_EEPROM, &eepromTask);
+#ifdef STATS_LOG_ENABLE
+    Scheduler_AddTask(APPLICATION_TASK_LOG, &logTask);
+    TimerWheel_Arm(TimerWheel_Create(&onStatsLogTimer), STATS_LOG_PERIOD, STATS_LOG_PERIOD);
+#endif
+    
+#ifdef KEY_MATRIX_ENABLE
+    KeyMatrix_Initialize();
+#endif
     
-    //USB Bus State
-    APPLICATION_USB_STATE usbState = APPLICATION_USB_NOT_INIT;
+    //Load the keymap from EEPROM, and allow the host to change it
+    Keymap_Initialize();
+    KeymapFeature_Initialize();
+    Macro_Initialize();
+    KeyEngine_Initialize();
+    Combo_Initialize();
+    
+    ButtonScan_Initialize();
+    PinCapture_Initialize();
+#ifdef ANALOG_KEYS_ENABLE
+    AnalogKeys_Initialize();
+#endif
     
     //Period Callback
     RTC_SetOVFIsrCallback(&onRTC_Overflow);
-        
+    ScanRate_Initialize();
+    
+    //VBUS Detection
+    VBUSMonitor_Initialize();
+    
+    //Low Power Sleep
+    SleepManager_Initialize();
+    
     //Enable Interrupts
     sei();
     
-    //Keep track of the number of USB_Retries
-    uint8_t retryCount = 0;
+    //Start the USB
+    Scheduler_Post(APPLICATION_TASK_USB);
     
     while(1)
     {
-        //If VUSB is present and no errors have occurred
-        if ((AC0_Read()) && (usbState != APPLICATION_USB_ERROR))
-        {    
-            //Has the USB been initialized?
-            if (usbState == APPLICATION_USB_NOT_INIT)
-            {
-                //Need to start USB
-                if (USB_Start() == SUCCESS)
-                {
-                    usbState = APPLICATION_USB_INIT;
-                    printf("USB Started\r\n");
-                }
-                else if (retryCount < USB_INIT_RETRIES)
-                {
-                    //Failed to init, stop the USB peripheral, increment count
-                    retryCount++;
-                    USB_Stop();
-                }
-                else
-                {
-                    //Failed to init
-                    usbState = APPLICATION_USB_ERROR;
-                    printf("Failed to start USB\r\n");
-                }
-            }
-            else
-            {
-                //USB has been initialized
-                
-                //Has a key changed state?
-                if (shouldSendKeyEvent)
-                {
-                    shouldSendKeyEvent = false;
-                    USB_HIDKeyboardReportInSend(&keyReport); 
-                }
-
-                //Handle USB Events
-                if (USBDevice_Handle() != SUCCESS)
-                {
-                    //Unable to handle USB Events
-
-                    //Try to reset USB
-                    if (USB_Reset() != SUCCESS)
-                    {
-                        printf("An error has occurred\r\n");
-                        usbState = APPLICATION_USB_ERROR;
-                    }
-                }
-            }
+        //Run one task, then check the higher priorities again
+        if (Scheduler_RunNext())
+        {
+            continue;
+        }
+        
+        //Work out how deep we can sleep
+        cli();
+        if (Scheduler_IsReady())
+        {
+            //A task was posted by an interrupt
+            SleepManager_Limit(SLEEP_LEVEL_NONE);
+        }
+        else if (!VBUSMonitor_IsPresent())
+        {
+            //Only the VBUS comparator needs to run
+            SleepManager_Limit(SLEEP_LEVEL_STANDBY);
         }
         else
         {
-            //VUSB is not present
-            
-            USB_Stop();
-            usbState = APPLICATION_USB_NOT_INIT;
-            retryCount = 0;
-
-            printf("No USB Voltage\r\n");
-            DELAY_milliseconds(500);
+            //Key scanning and USB need their clocks
+            SleepManager_Limit(SLEEP_LEVEL_IDLE);
+        }
+        
+        //No timer is armed - stop the TCB0 interrupt, so it does not wake the CPU
+        if (TimerWheel_IsIdle())
+        {
+            Timebase_Suspend();
         }
+        
+        //Sleep until the next event
+        SleepManager_Sleep();
+        Timebase_Resume();
+        
+        //Poll the USB after every wake
+        Scheduler_Post(APPLICATION_TASK_USB);
     }    
 }
\ No newline at end of file
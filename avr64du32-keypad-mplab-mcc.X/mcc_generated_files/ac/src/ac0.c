@@ -41,14 +41,14 @@ int8_t AC0_Initialize(void)
     //DACREF 50; 
     AC0.DACREF = 0x32;
     
-    //CMP disabled; INTMODE Positive and negative inputs crosses; 
-    AC0.INTCTRL = 0x0;
+    //CMP enabled; INTMODE Positive and negative inputs crosses; 
+    AC0.INTCTRL = 0x1;
     
     //INITVAL LOW; INVERT disabled; MUXNEG DAC Reference; MUXPOS Positive Pin 4;   
     AC0.MUXCTRL = 0x24;
     
-    //ENABLE enabled; HYSMODE No hysteresis; OUTEN disabled; POWER Power profile 0, lowest consumption and highest response time.; RUNSTDBY disabled; 
-    AC0.CTRLA = 0x1;
+    //ENABLE enabled; HYSMODE Medium hysteresis; OUTEN disabled; POWER Power profile 0, lowest consumption and highest response time.; RUNSTDBY enabled; 
+    AC0.CTRLA = 0x85;
 
     return 0;
 }
@@ -0,0 +1,129 @@
+/**
+ * ADC0 Generated Driver API Header File
+ * 
+ * @file adc0.h
+ * 
+ * @defgroup  adc0 ADC0
+ * 
+ * @brief Contains the API prototypes for the ADC0 driver.
+ *
+ * @version ADC0 Driver Version 1.0.0
+*/
+/*
+ [2024] Microchip Technology Inc. and its subsidiaries.
+
+    Subject to your compliance with these terms, you may use Microchip 
+    software and any derivatives exclusively with Microchip products. 
+    You are responsible for complying with 3rd party license terms  
+    applicable to your use of 3rd party software (including open source  
+    software) that may accompany Microchip software. SOFTWARE IS ?AS IS.? 
+    NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS 
+    SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,  
+    MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT 
+    WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY 
+    KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF 
+    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE 
+    FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP?S 
+    TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL NOT 
+    EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR 
+    THIS SOFTWARE.
+*/
+
+
+#ifndef ADC0_H_INCLUDED
+#define ADC0_H_INCLUDED
+
+#include "../system/utils/compiler.h"
+
+#ifdef __cplusplus  
+extern "C" {
+#endif
+
+/**
+ * @ingroup adc0
+ * @brief Data type for the result of an ADC0 conversion (accumulated samples).
+ */
+typedef uint16_t adc_result_t;
+
+/**
+ * @ingroup adc0
+ * @brief Data type for the ADC0 positive input channel (MUXPOS value).
+ */
+typedef uint8_t adc_0_channel_t;
+
+/**
+ * @ingroup adc0
+ * @brief Initializes the ADC0. This routine is called only once during system initialization, before calling other APIs.
+ * @param None.
+ * @retval 0 - ADC0 is initialized successfully.
+*/
+int8_t ADC0_Initialize(void);
+
+/**
+ * @ingroup adc0
+ * @brief Enables the ADC0.
+ * @param None.
+ * @return None.
+ */
+void ADC0_Enable(void);
+
+/**
+ * @ingroup adc0
+ * @brief Disables the ADC0.
+ * @param None.
+ * @return None.
+ */
+void ADC0_Disable(void);
+
+/**
+ * @ingroup adc0
+ * @brief Selects the positive input channel for the next conversion.
+ * @pre Initialize the ADC0 with ADC0_Initialize() before calling this API.
+ * @param channel - MUXPOS value of the channel.
+ * @return None.
+ */
+void ADC0_ChannelSelect(adc_0_channel_t channel);
+
+/**
+ * @ingroup adc0
+ * @brief Starts a conversion on the selected channel.
+ * @pre Initialize the ADC0 with ADC0_Initialize() before calling this API.
+ * @param None.
+ * @return None.
+ */
+void ADC0_ConversionStart(void);
+
+/**
+ * @ingroup adc0
+ * @brief Checks if the last conversion has finished.
+ * @pre Start a conversion with ADC0_ConversionStart() before calling this API.
+ * @param None.
+ * @retval True - The result is ready.
+ * @retval False - The conversion is in progress.
+ */
+bool ADC0_IsConversionDone(void);
+
+/**
+ * @ingroup adc0
+ * @brief Returns the result of the last conversion and clears the result ready flag.
+ * @pre Check that the conversion is done with ADC0_IsConversionDone() before calling this API.
+ * @param None.
+ * @return Sum of the accumulated samples.
+ */
+adc_result_t ADC0_GetConversionResult(void);
+
+/**
+ * @ingroup adc0
+ * @brief Converts a channel, waiting for the result.
+ * @pre Initialize the ADC0 with ADC0_Initialize() before calling this API.
+ * @param channel - MUXPOS value of the channel.
+ * @return Sum of the accumulated samples.
+ */
+adc_result_t ADC0_GetConversion(adc_0_channel_t channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* ADC0_H_INCLUDED */
\ No newline at end of file
@@ -0,0 +1,103 @@
+/**
+ * ADC0 Generated Driver File
+ * 
+ * @file adc0.c
+ * 
+ * @ingroup  adc0
+ * 
+ * @brief Contains the API implementation for the ADC0 driver.
+ *
+ * @version ADC0 Driver Version 1.0.0
+*/
+/*
+ [2024] Microchip Technology Inc. and its subsidiaries.
+
+    Subject to your compliance with these terms, you may use Microchip 
+    software and any derivatives exclusively with Microchip products. 
+    You are responsible for complying with 3rd party license terms  
+    applicable to your use of 3rd party software (including open source  
+    software) that may accompany Microchip software. SOFTWARE IS ?AS IS.? 
+    NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS 
+    SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,  
+    MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT 
+    WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY 
+    KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF 
+    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE 
+    FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP?S 
+    TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL NOT 
+    EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR 
+    THIS SOFTWARE.
+*/
+
+#include "../adc0.h"
+
+int8_t ADC0_Initialize(void) 
+{
+    //SAMPNUM 4 results accumulated; 
+    ADC0.CTRLB = 0x2;
+    
+    //PRESC CLK_PER divided by 16; 
+    ADC0.CTRLC = 0x7;
+    
+    //INITDLY DLY0; SAMPDLY DLY0; 
+    ADC0.CTRLD = 0x0;
+    
+    //SAMPLEN 0; 
+    ADC0.SAMPCTRL = 0x0;
+    
+    //MUXPOS AIN0; 
+    ADC0.MUXPOS = 0x0;
+    
+    //RESRDY disabled; WCMP disabled; 
+    ADC0.INTCTRL = 0x0;
+    
+    //ENABLE disabled; FREERUN disabled; LEFTADJ disabled; RUNSTBY disabled; 
+    ADC0.CTRLA = 0x0;
+
+    return 0;
+}
+
+void ADC0_Enable(void)
+{
+    ADC0.CTRLA |= ADC_ENABLE_bm;
+}
+
+void ADC0_Disable(void)
+{
+    ADC0.CTRLA &= ~ADC_ENABLE_bm;
+}
+
+void ADC0_ChannelSelect(adc_0_channel_t channel)
+{
+    ADC0.MUXPOS = channel;
+}
+
+void ADC0_ConversionStart(void)
+{
+    ADC0.COMMAND = ADC_STCONV_bm;
+}
+
+bool ADC0_IsConversionDone(void)
+{
+    return ((ADC0.INTFLAGS & ADC_RESRDY_bm) != 0);
+}
+
+adc_result_t ADC0_GetConversionResult(void)
+{
+    //Reading RES clears RESRDY
+    return (ADC0.RES);
+}
+
+adc_result_t ADC0_GetConversion(adc_0_channel_t channel)
+{
+    ADC0_ChannelSelect(channel);
+    ADC0_ConversionStart();
+    
+    while (!ADC0_IsConversionDone())
+    {
+        ;
+    }
+    
+    return ADC0_GetConversionResult();
+}
\ No newline at end of file
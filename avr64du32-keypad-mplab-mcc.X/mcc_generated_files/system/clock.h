@@ -50,6 +50,22 @@
  */
 void CLOCK_Initialize(void);
 
+/**
+ * @ingroup clkctrl
+ * @brief Select the autotune reference of the internal high-frequency oscillator
+ * @param CLKCTRL_AUTOTUNE_t mode - CLKCTRL_AUTOTUNE_SOF_gc locks OSCHF to the USB Start-of-Frame
+ * @return none
+ */
+void CLOCK_AutoTuneSet(CLKCTRL_AUTOTUNE_t mode);
+
+/**
+ * @ingroup clkctrl
+ * @brief Get the correction currently applied to OSCHF by autotune
+ * @param none
+ * @return int8_t - Signed OSCHFTUNE value, in tuning steps
+ */
+int8_t CLOCK_TuneErrorGet(void);
+
 /**
  * @ingroup clkctrl
  * @brief Enable Clock Failure Detection on main clock
@@ -50,6 +50,38 @@ extern "C" {
  */
 int8_t CPUINT_Initialize();
 
+/**
+ * @ingroup interrupt
+ * @brief Sets the vector with level 1 (high) priority. A level 1 interrupt can interrupt a level 0 interrupt. Only one vector can be level 1.
+ * @param uint8_t vector - Vector number (e.g. USB0_TRNCOMPL_vect_num), or 0 for none
+ * @return None.
+ */
+void CPUINT_Level1VectorSet(uint8_t vector);
+
+/**
+ * @ingroup interrupt
+ * @brief Sets the level 0 vector with the highest priority. The other vectors follow in vector order, wrapping around.
+ * @param uint8_t vector - Vector number (e.g. USB0_BUSEVENT_vect_num), 1 for the default order
+ * @return None.
+ */
+void CPUINT_Level0PrioritySet(uint8_t vector);
+
+/**
+ * @ingroup interrupt
+ * @brief Enables round-robin scheduling of the level 0 vectors. The last vector acknowledged gets the lowest priority, replacing the order set by CPUINT_Level0PrioritySet.
+ * @param None.
+ * @return None.
+ */
+void CPUINT_RoundRobinEnable(void);
+
+/**
+ * @ingroup interrupt
+ * @brief Disables round-robin scheduling of the level 0 vectors.
+ * @param None.
+ * @return None.
+ */
+void CPUINT_RoundRobinDisable(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -49,8 +49,8 @@ void CLOCK_Initialize(void)
     //RUNSTDBY disabled; 
     ccp_write_io((void*)&(CLKCTRL.OSC32KCTRLA),0x0);
 
-    //AUTOTUNE OFF; FRQSEL 20 MHz system clock; RUNSTDBY disabled; ALGSEL BIN; 
-    ccp_write_io((void*)&(CLKCTRL.OSCHFCTRLA),0x20);
+    //AUTOTUNE SOF; FRQSEL 20 MHz system clock; RUNSTDBY disabled; ALGSEL BIN; 
+    ccp_write_io((void*)&(CLKCTRL.OSCHFCTRLA),0x22);
 
     //TUNE 0x0; 
     ccp_write_io((void*)&(CLKCTRL.OSCHFTUNE),0x0);
@@ -87,6 +87,18 @@ void CLOCK_Initialize(void)
     // System clock stability check by polling the PLL status.
 }
 
+void CLOCK_AutoTuneSet(CLKCTRL_AUTOTUNE_t mode)
+{
+    /* Select the reference OSCHF is tuned against */
+    ccp_write_io((uint8_t *) & CLKCTRL.OSCHFCTRLA, (CLKCTRL.OSCHFCTRLA & ~CLKCTRL_AUTOTUNE_gm) | mode);
+}
+
+int8_t CLOCK_TuneErrorGet(void)
+{
+    /* The tuning applied by autotune is the measured oscillator error */
+    return (int8_t)CLKCTRL.OSCHFTUNE;
+}
+
 void CFD_Enable(CLKCTRL_CFDSRC_t cfd_source)
 {
     /* Enable Clock Failure Detection on main clock */
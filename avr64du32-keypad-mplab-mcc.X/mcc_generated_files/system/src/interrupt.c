@@ -41,12 +41,33 @@ int8_t CPUINT_Initialize()
     //CVT disabled; IVSEL disabled; LVL0RR disabled; 
     ccp_write_io((void*)&(CPUINT.CTRLA),0x0);
     
-    //LVL0PRI 0; 
-    CPUINT.LVL0PRI = 0x0;
+    //LVL0PRI USB0_BUSEVENT - 1; USB0 bus events have the highest level 0 priority
+    CPUINT_Level0PrioritySet(USB0_BUSEVENT_vect_num);
     
-    //LVL1VEC 0; 
-    CPUINT.LVL1VEC = 0x0;
+    //LVL1VEC USB0_TRNCOMPL; USB0 transaction complete interrupts other interrupts
+    CPUINT_Level1VectorSet(USB0_TRNCOMPL_vect_num);
 
         
     return 0;
+}
+
+void CPUINT_Level1VectorSet(uint8_t vector)
+{
+    CPUINT.LVL1VEC = vector;
+}
+
+void CPUINT_Level0PrioritySet(uint8_t vector)
+{
+    //The vector after LVL0PRI has the highest priority
+    CPUINT.LVL0PRI = vector - 1;
+}
+
+void CPUINT_RoundRobinEnable(void)
+{
+    ccp_write_io((void*)&(CPUINT.CTRLA), CPUINT.CTRLA | CPUINT_LVL0RR_bm);
+}
+
+void CPUINT_RoundRobinDisable(void)
+{
+    ccp_write_io((void*)&(CPUINT.CTRLA), CPUINT.CTRLA & ~CPUINT_LVL0RR_bm);
 }
\ No newline at end of file
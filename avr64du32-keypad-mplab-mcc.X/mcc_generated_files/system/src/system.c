@@ -42,8 +42,11 @@ void SYSTEM_Initialize(void)
     USB0_Initialize();
     AC0_Initialize();
     RTC_Initialize();
+    TCB0_Initialize();
+    TCB1_Initialize();
     USART1_Initialize();
     VREF_Initialize();
+    ADC0_Initialize();
     USBDevice_Initialize();
     CPUINT_Initialize();
 }
@@ -46,7 +46,10 @@ extern "C" {
 #include "../system/pins.h"
 #include "../usb/usb0.h"
 #include "../ac/ac0.h"
+#include "../adc/adc0.h"
 #include "../timer/rtc.h"
+#include "../timer/tcb0.h"
+#include "../timer/tcb1.h"
 #include "../uart/usart1.h"
 #include "../vref/vref.h"
 #include "../usb/usb_device.h"
@@ -72,6 +72,9 @@ int8_t RTC_Initialize(void)
     // PI disabled; 
 	RTC.PITINTCTRL = 0x0;
 
+    // PERIOD RTC Clock Cycles 8; PITEN enabled; 
+    RTC.PITCTRLA = 0x11;
+
     // DBGRUN disabled; 
     RTC.PITDBGCTRL = 0x0;
 
@@ -0,0 +1,118 @@
+/**
+ * TCB0 Generated Driver File
+ * 
+ * @file tcb0.c
+ * 
+ * @ingroup  tcb0
+ * 
+ * @brief Contains the API implementation for the TCB0 driver in Periodic Interrupt mode.
+ *
+ * @version TCB0 Driver Version 1.0.0
+*/
+/*
+ [2024] Microchip Technology Inc. and its subsidiaries.
+
+    Subject to your compliance with these terms, you may use Microchip 
+    software and any derivatives exclusively with Microchip products. 
+    You are responsible for complying with 3rd party license terms  
+    applicable to your use of 3rd party software (including open source  
+    software) that may accompany Microchip software. SOFTWARE IS ?AS IS.? 
+    NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS 
+    SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,  
+    MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT 
+    WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY 
+    KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF 
+    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE 
+    FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP?S 
+    TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL NOT 
+    EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR 
+    THIS SOFTWARE.
+*/
+
+#include "../tcb0.h"
+
+static TCB0_cb_t TCB0_period_cb = NULL;
+
+int8_t TCB0_Initialize(void) 
+{
+    //CNTMODE INT; 
+    TCB0.CTRLB = 0x0;
+    
+    //Period 5 ms (CCMP + 1 counts of 100 ns)
+    TCB0.CCMP = 0xC34F;
+    
+    //Count
+    TCB0.CNT = 0x0;
+    
+    //CAPT enabled; OVF disabled; 
+    TCB0.INTCTRL = 0x1;
+    
+    //Clear the flags
+    TCB0.INTFLAGS = (TCB_CAPT_bm | TCB_OVF_bm);
+    
+    //DBGRUN enabled; 
+    TCB0.DBGCTRL = 0x1;
+    
+    //CASCADE disabled; CLKSEL CLK_PER / 2; ENABLE enabled; RUNSTDBY disabled; SYNCUPD disabled; 
+    TCB0.CTRLA = 0x3;
+
+    return 0;
+}
+
+void TCB0_Start(void)
+{
+    TCB0.CTRLA |= TCB_ENABLE_bm;
+}
+
+void TCB0_Stop(void)
+{
+    TCB0.CTRLA &= ~TCB_ENABLE_bm;
+}
+
+void TCB0_PeriodInterruptEnable(void)
+{
+    TCB0.INTCTRL |= TCB_CAPT_bm;
+}
+
+void TCB0_PeriodInterruptDisable(void)
+{
+    TCB0.INTCTRL &= ~TCB_CAPT_bm;
+}
+
+void TCB0_PeriodFlagClear(void)
+{
+    TCB0.INTFLAGS = TCB_CAPT_bm;
+}
+
+void TCB0_PeriodCallbackRegister(TCB0_cb_t cb)
+{
+    TCB0_period_cb = cb;
+}
+
+uint16_t TCB0_CounterGet(void)
+{
+    //Reading CNTL latches CNTH
+    return (TCB0.CNT);
+}
+
+uint16_t TCB0_PeriodGet(void)
+{
+    return (TCB0.CCMP);
+}
+
+bool TCB0_IsPeriodPending(void)
+{
+    return ((TCB0.INTFLAGS & TCB_CAPT_bm) != 0);
+}
+
+ISR(TCB0_INT_vect)
+{
+    //In Periodic Interrupt mode, CAPT is set when the count matches CCMP
+    TCB0.INTFLAGS = TCB_CAPT_bm;
+    
+    if (TCB0_period_cb != NULL)
+    {
+        (*TCB0_period_cb)();
+    }
+}
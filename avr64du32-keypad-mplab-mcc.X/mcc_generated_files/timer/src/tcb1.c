@@ -0,0 +1,93 @@
+/**
+ * TCB1 Generated Driver File
+ * 
+ * @file tcb1.c
+ * 
+ * @ingroup  tcb1
+ * 
+ * @brief Contains the API implementation for the TCB1 driver as a one-shot timeout, in Periodic Interrupt mode.
+ *
+ * @version TCB1 Driver Version 1.0.0
+*/
+/*
+ [2024] Microchip Technology Inc. and its subsidiaries.
+
+    Subject to your compliance with these terms, you may use Microchip 
+    software and any derivatives exclusively with Microchip products. 
+    You are responsible for complying with 3rd party license terms  
+    applicable to your use of 3rd party software (including open source  
+    software) that may accompany Microchip software. SOFTWARE IS ?AS IS.? 
+    NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS 
+    SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,  
+    MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT 
+    WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY 
+    KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF 
+    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE 
+    FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP?S 
+    TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL NOT 
+    EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR 
+    THIS SOFTWARE.
+*/
+
+#include "../tcb1.h"
+
+static TCB1_cb_t TCB1_timeout_cb = NULL;
+
+int8_t TCB1_Initialize(void) 
+{
+    //CNTMODE INT; 
+    TCB1.CTRLB = 0x0;
+    
+    //Timeout, set by TCB1_TimeoutStart
+    TCB1.CCMP = 0x0;
+    
+    //Count
+    TCB1.CNT = 0x0;
+    
+    //CAPT enabled; OVF disabled; 
+    TCB1.INTCTRL = 0x1;
+    
+    //Clear the flags
+    TCB1.INTFLAGS = (TCB_CAPT_bm | TCB_OVF_bm);
+    
+    //DBGRUN enabled; 
+    TCB1.DBGCTRL = 0x1;
+    
+    //CASCADE disabled; CLKSEL CLK_PER / 2; ENABLE disabled; RUNSTDBY disabled; SYNCUPD disabled; 
+    TCB1.CTRLA = 0x2;
+
+    return 0;
+}
+
+void TCB1_TimeoutStart(uint16_t counts)
+{
+    TCB1.CTRLA &= ~TCB_ENABLE_bm;
+    TCB1.CNT = 0x0;
+    TCB1.CCMP = counts;
+    TCB1.INTFLAGS = TCB_CAPT_bm;
+    TCB1.CTRLA |= TCB_ENABLE_bm;
+}
+
+void TCB1_Stop(void)
+{
+    TCB1.CTRLA &= ~TCB_ENABLE_bm;
+    TCB1.INTFLAGS = TCB_CAPT_bm;
+}
+
+void TCB1_TimeoutCallbackRegister(TCB1_cb_t cb)
+{
+    TCB1_timeout_cb = cb;
+}
+
+ISR(TCB1_INT_vect)
+{
+    //In Periodic Interrupt mode, CAPT is set when the count matches CCMP - stop after the first match
+    TCB1.CTRLA &= ~TCB_ENABLE_bm;
+    TCB1.INTFLAGS = TCB_CAPT_bm;
+    
+    if (TCB1_timeout_cb != NULL)
+    {
+        (*TCB1_timeout_cb)();
+    }
+}
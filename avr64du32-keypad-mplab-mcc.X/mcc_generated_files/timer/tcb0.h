@@ -0,0 +1,141 @@
+/**
+ * TCB0 Generated Driver API Header File
+ * 
+ * @file tcb0.h
+ * 
+ * @defgroup  tcb0 TCB0
+ * 
+ * @brief Contains the API prototypes for the TCB0 driver in Periodic Interrupt mode.
+ *
+ * @version TCB0 Driver Version 1.0.0
+*/
+/*
+ [2024] Microchip Technology Inc. and its subsidiaries.
+
+    Subject to your compliance with these terms, you may use Microchip 
+    software and any derivatives exclusively with Microchip products. 
+    You are responsible for complying with 3rd party license terms  
+    applicable to your use of 3rd party software (including open source  
+    software) that may accompany Microchip software. SOFTWARE IS ?AS IS.? 
+    NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS 
+    SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,  
+    MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT 
+    WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY 
+    KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF 
+    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE 
+    FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP?S 
+    TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL NOT 
+    EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR 
+    THIS SOFTWARE.
+*/
+
+
+#ifndef TCB0_H_INCLUDED
+#define TCB0_H_INCLUDED
+
+#include "../system/utils/compiler.h"
+
+#ifdef __cplusplus  
+extern "C" {
+#endif
+
+/**
+ * @ingroup tcb0
+ * @brief Counts per microsecond (CLK_PER / 2).
+ */
+#define TCB0_COUNTS_PER_US (F_CPU / 2000000UL)
+
+/**
+ * @ingroup tcb0
+ * @typedef void TCB0_cb_t
+ * @brief Function pointer to the callback function called when the counter reaches the period. The default value is set to NULL which means that no callback function will be used.
+ */ 
+typedef void (*TCB0_cb_t)(void);
+
+/**
+ * @ingroup tcb0
+ * @brief Initializes the TCB0. This routine is called only once during system initialization, before calling other APIs.
+ * @param None.
+ * @retval 0 - TCB0 is initialized successfully.
+*/
+int8_t TCB0_Initialize(void);
+
+/**
+ * @ingroup tcb0
+ * @brief Starts the counter.
+ * @param None.
+ * @return None.
+ */
+void TCB0_Start(void);
+
+/**
+ * @ingroup tcb0
+ * @brief Stops the counter.
+ * @param None.
+ * @return None.
+ */
+void TCB0_Stop(void);
+
+/**
+ * @ingroup tcb0
+ * @brief Enables the period interrupt.
+ * @param None.
+ * @return None.
+ */
+void TCB0_PeriodInterruptEnable(void);
+
+/**
+ * @ingroup tcb0
+ * @brief Disables the period interrupt. The counter keeps running, and the flag is still set at each period.
+ * @param None.
+ * @return None.
+ */
+void TCB0_PeriodInterruptDisable(void);
+
+/**
+ * @ingroup tcb0
+ * @brief Clears the period interrupt flag.
+ * @param None.
+ * @return None.
+ */
+void TCB0_PeriodFlagClear(void);
+
+/**
+ * @ingroup tcb0
+ * @brief Registers a callback function to be called when the counter reaches the period.
+ * @param cb - Callback function, called from the TCB0 interrupt.
+ * @return None.
+ */
+void TCB0_PeriodCallbackRegister(TCB0_cb_t cb);
+
+/**
+ * @ingroup tcb0
+ * @brief Returns the current count.
+ * @param None.
+ * @return Count, from 0 to the period.
+ */
+uint16_t TCB0_CounterGet(void);
+
+/**
+ * @ingroup tcb0
+ * @brief Returns the period of the counter.
+ * @param None.
+ * @return Last count before the counter restarts at 0.
+ */
+uint16_t TCB0_PeriodGet(void);
+
+/**
+ * @ingroup tcb0
+ * @brief Checks if the counter has restarted and the interrupt has not been handled yet.
+ * @param None.
+ * @retval True - The period interrupt is pending.
+ * @retval False - No period interrupt is pending.
+ */
+bool TCB0_IsPeriodPending(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* TCB0_H_INCLUDED */
\ No newline at end of file
@@ -0,0 +1,93 @@
+/**
+ * TCB1 Generated Driver API Header File
+ * 
+ * @file tcb1.h
+ * 
+ * @defgroup  tcb1 TCB1
+ * 
+ * @brief Contains the API prototypes for the TCB1 driver as a one-shot timeout, in Periodic Interrupt mode.
+ *
+ * @version TCB1 Driver Version 1.0.0
+*/
+/*
+ [2024] Microchip Technology Inc. and its subsidiaries.
+
+    Subject to your compliance with these terms, you may use Microchip 
+    software and any derivatives exclusively with Microchip products. 
+    You are responsible for complying with 3rd party license terms  
+    applicable to your use of 3rd party software (including open source  
+    software) that may accompany Microchip software. SOFTWARE IS ?AS IS.? 
+    NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS 
+    SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,  
+    MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT 
+    WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY 
+    KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF 
+    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE 
+    FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP?S 
+    TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL NOT 
+    EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR 
+    THIS SOFTWARE.
+*/
+
+
+#ifndef TCB1_H_INCLUDED
+#define TCB1_H_INCLUDED
+
+#include "../system/utils/compiler.h"
+
+#ifdef __cplusplus  
+extern "C" {
+#endif
+
+/**
+ * @ingroup tcb1
+ * @brief Counts per microsecond (CLK_PER / 2).
+ */
+#define TCB1_COUNTS_PER_US (F_CPU / 2000000UL)
+
+/**
+ * @ingroup tcb1
+ * @typedef void TCB1_cb_t
+ * @brief Function pointer to the callback function called when the timeout expires. The default value is set to NULL which means that no callback function will be used.
+ */ 
+typedef void (*TCB1_cb_t)(void);
+
+/**
+ * @ingroup tcb1
+ * @brief Initializes the TCB1. This routine is called only once during system initialization, before calling other APIs.
+ * The counter is left stopped until TCB1_TimeoutStart.
+ * @param None.
+ * @retval 0 - TCB1 is initialized successfully.
+*/
+int8_t TCB1_Initialize(void);
+
+/**
+ * @ingroup tcb1
+ * @brief Restarts the counter from 0. The counter stops, and the callback is called, once it reaches counts.
+ * @param counts - Timeout, in counts of TCB1_COUNTS_PER_US per microsecond (0 expires on the first count).
+ * @return None.
+ */
+void TCB1_TimeoutStart(uint16_t counts);
+
+/**
+ * @ingroup tcb1
+ * @brief Stops the counter, so a running timeout does not expire.
+ * @param None.
+ * @return None.
+ */
+void TCB1_Stop(void);
+
+/**
+ * @ingroup tcb1
+ * @brief Registers a callback function to be called when the timeout expires.
+ * @param cb - Callback function, called from the TCB1 interrupt.
+ * @return None.
+ */
+void TCB1_TimeoutCallbackRegister(TCB1_cb_t cb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* TCB1_H_INCLUDED */
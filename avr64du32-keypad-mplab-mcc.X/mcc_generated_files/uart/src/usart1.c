@@ -287,6 +287,7 @@ uint8_t USART1_Read(void)
 
 void USART1_Write(uint8_t txData)
 {
+    USART1.STATUS = USART_TXCIF_bm; // Clear the Transmit Complete flag so USART1_IsTxDone tracks this byte.
     USART1.TXDATAL = txData;    // Write the data byte to the USART.
 }
 static void USART1_DefaultFramingErrorCallback(void)
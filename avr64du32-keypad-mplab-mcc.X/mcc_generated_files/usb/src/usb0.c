@@ -59,6 +59,22 @@ void USB0_BusEventCallbackRegister(USB_cb_t cb)
     USB0_BusEvent_isr_cb = cb;
 }
 
+void USB0_BusEventInterruptEnable(uint8_t mask)
+{
+    USB0.INTCTRLA = mask;
+}
+
+void USB0_TrnComplInterruptEnable(uint8_t mask)
+{
+    USB0.INTCTRLB = mask;
+}
+
+void USB0_InterruptsDisable(void)
+{
+    USB0.INTCTRLA = 0x0;
+    USB0.INTCTRLB = 0x0;
+}
+
 static void USB0_DefaultTrnComplCallback(void)
 {
     // Clear the interrupt Flags
@@ -33,6 +33,8 @@
 #ifndef USB0_H
 #define USB0_H
 
+#include <stdint.h>
+
 /**
  * @ingroup usb0
  * @typedef void *USB_cb_t
@@ -68,6 +70,30 @@ void USB0_TrnComplCallbackRegister(USB_cb_t cb);
  */ 
 void USB0_BusEventCallbackRegister(USB_cb_t cb);
 
+/**
+ * @ingroup usb0
+ * @brief Enables the selected Bus Event interrupts.
+ * @param uint8_t mask - Bitmask of the INTCTRLA interrupts to enable, all others are disabled
+ * @return None.
+ */ 
+void USB0_BusEventInterruptEnable(uint8_t mask);
+
+/**
+ * @ingroup usb0
+ * @brief Enables the selected Transaction Complete interrupts.
+ * @param uint8_t mask - Bitmask of the INTCTRLB interrupts to enable, all others are disabled
+ * @return None.
+ */ 
+void USB0_TrnComplInterruptEnable(uint8_t mask);
+
+/**
+ * @ingroup usb0
+ * @brief Disables all USB0 interrupts. The interrupt flags are left untouched.
+ * @param None.
+ * @return None.
+ */ 
+void USB0_InterruptsDisable(void);
+
 #endif // USB0_H
 /**
  End of File
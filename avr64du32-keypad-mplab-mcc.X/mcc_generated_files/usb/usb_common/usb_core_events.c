@@ -43,79 +43,135 @@
 
 USB_EVENT_HANDLERS_t event;
 
-RETURN_CODE_t USB_EventHandler(void)
+/**
+ * @ingroup usb_core
+ * @struct USB_EVENT_DISPATCH_struct
+ * @brief Associates a set of bus events with the routine handling them.
+ */
+typedef struct USB_EVENT_DISPATCH_struct
+{
+    uint8_t events;
+    RETURN_CODE_t (*handler)(void);
+} USB_EVENT_DISPATCH_t;
+
+STATIC RETURN_CODE_t USB_EventResetHandle(void)
 {
     RETURN_CODE_t status = SUCCESS;
 
-    if (USB_EventSOFIsReceived() == true)
+    if (NULL != event.ResetCallback)
     {
-        USB_EventSOFClear();
-        if (NULL != event.SOFCallback)
-        {
-            event.SOFCallback();
-        }
+        event.ResetCallback();
     }
-    if (USB_EventResetIsReceived() == true)
+    USB_PIPE_t pipe = { .address = 0 };
+    while (pipe.address < USB_EP_NUM)
     {
-        USB_EventResetClear();
-        if (NULL != event.ResetCallback)
+        pipe.direction = USB_EP_DIR_IN;
+        if (SUCCESS == status)
         {
-            event.ResetCallback();
+            status = USB_TransferAbort(pipe);
         }
-        USB_PIPE_t pipe = { .address = 0 };
-        while (pipe.address < USB_EP_NUM)
+        pipe.direction = USB_EP_DIR_OUT;
+        if (SUCCESS == status)
         {
-            pipe.direction = USB_EP_DIR_IN;
-            if (SUCCESS == status)
-            {
-                status = USB_TransferAbort(pipe);
-            }
-            pipe.direction = USB_EP_DIR_OUT;
-            if (SUCCESS == status)
-            {
-                status = USB_TransferAbort(pipe);
-            }
-            pipe.address++;
+            status = USB_TransferAbort(pipe);
         }
-        status = USB_Reset();
+        pipe.address++;
     }
-    uint8_t eventOverUnderflow = USB_EventOverUnderflowIsReceived();
-    if (0u < eventOverUnderflow)
+    status = USB_Reset();
+
+    return status;
+}
+
+STATIC RETURN_CODE_t USB_EventStalledHandle(void)
+{
+    USB_PIPE_t pipe = { .address = 0x00, .direction = USB_EP_DIR_OUT };
+    return USB_HandleEventStalled(pipe);
+}
+
+STATIC RETURN_CODE_t USB_EventOverUnderflowHandle(void)
+{
+    RETURN_CODE_t status = SUCCESS;
+
+    uint8_t controlOverUnderflow = USB_ControlOverUnderflowIsReceived();
+    if (0u < controlOverUnderflow)
     {
-        USB_EventOverUnderflowClear();
-        uint8_t controlOverUnderflow = USB_ControlOverUnderflowIsReceived();
-        if (0u < controlOverUnderflow)
-        {
-            status = USB_ControlProcessOverUnderflow(controlOverUnderflow);
-        }
-        else
-        {
-            // Non-control overunderflows currently ignored by event handler
-            status = SUCCESS;
-        }
+        status = USB_ControlProcessOverUnderflow(controlOverUnderflow);
     }
-    if (USB_EventSuspendIsReceived() == true)
+    // Non-control overunderflows currently ignored by event handler
+
+    return status;
+}
+
+STATIC RETURN_CODE_t USB_EventSuspendHandle(void)
+{
+    if (NULL != event.SuspendCallback)
     {
-        USB_EventSuspendClear();
-        if (NULL != event.SuspendCallback)
-        {
-            event.SuspendCallback();
-        }
+        event.SuspendCallback();
     }
-    if (USB_EventResumeIsReceived() == true)
+    return SUCCESS;
+}
+
+STATIC RETURN_CODE_t USB_EventResumeHandle(void)
+{
+    if (NULL != event.ResumeCallback)
     {
-        USB_EventResumeClear();
-        if (NULL != event.ResumeCallback)
-        {
-            event.ResumeCallback();
-        }
+        event.ResumeCallback();
     }
-    if (USB_EventStalledIsReceived() == true)
+    return SUCCESS;
+}
+
+STATIC RETURN_CODE_t USB_EventSOFHandle(void)
+{
+    event.SOFCallback();
+    return SUCCESS;
+}
+
+// Bus events in the order they are serviced, highest priority first.
+STATIC const USB_EVENT_DISPATCH_t eventDispatchTable[] = {
+    { .events = USB_EVENT_RESET, .handler = USB_EventResetHandle },
+    { .events = USB_EVENT_STALLED, .handler = USB_EventStalledHandle },
+    { .events = USB_EVENT_OVERFLOW | USB_EVENT_UNDERFLOW, .handler = USB_EventOverUnderflowHandle },
+    { .events = USB_EVENT_SUSPEND, .handler = USB_EventSuspendHandle },
+    { .events = USB_EVENT_RESUME, .handler = USB_EventResumeHandle },
+    { .events = USB_EVENT_SOF, .handler = USB_EventSOFHandle },
+};
+
+RETURN_CODE_t USB_EventHandler(void)
+{
+    RETURN_CODE_t status = SUCCESS;
+
+    // Takes a single snapshot of the pending events and clears them all at once.
+    uint8_t events = USB_EventsReceivedGet();
+
+    if (0u != events)
     {
-        USB_EventStalledClear();
-        USB_PIPE_t pipe = { .address = 0x00, .direction = USB_EP_DIR_OUT };
-        status = USB_HandleEventStalled(pipe);
+        USB_EventsClear(events);
+
+        // SOF events are dropped when no one is listening for them.
+        if (NULL == event.SOFCallback)
+        {
+            events &= (uint8_t)~USB_EVENT_SOF;
+        }
+
+        for (uint8_t index = 0; index < (sizeof(eventDispatchTable) / sizeof(eventDispatchTable[0])); index++)
+        {
+            if (0u != (events & eventDispatchTable[index].events))
+            {
+                RETURN_CODE_t eventStatus = eventDispatchTable[index].handler();
+                if (SUCCESS == status)
+                {
+                    status = eventStatus;
+                }
+
+                // A bus reset reinitializes the peripheral, the remaining events in the snapshot are stale.
+                if (USB_EVENT_RESET == eventDispatchTable[index].events)
+                {
+                    break;
+                }
+            }
+        }
     }
+
     return status;
 }
 
@@ -69,6 +69,10 @@ extern USB_EVENT_HANDLERS_t event;
 /**
  * @ingroup usb_core
  * @brief Handles the different types of events.
+ *
+ * Reads all pending bus events in one snapshot and services them in priority order: reset, stall, over/underflow,
+ * suspend, resume and Start-Of-Frame (SOF). SOF events are skipped if no SOF callback is registered.
+ *
  * @param None.
  * @return SUCCESS or an Error code according to RETURN_CODE_t
  */
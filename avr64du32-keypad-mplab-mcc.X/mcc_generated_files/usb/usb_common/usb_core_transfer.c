@@ -128,6 +128,38 @@ RETURN_CODE_t USB_TransferAbort(USB_PIPE_t pipe)
     return status;
 }
 
+STATIC RETURN_CODE_t USB_TransactionCompletedHandle(void)
+{
+    RETURN_CODE_t status = UNINITIALIZED;
+
+    // Finds out which pipe has a completed transaction.
+    USB_PIPE_t pipe;
+
+    status = USB_TransactionCompletedPipeGet(&pipe);
+
+    if (status == SUCCESS)
+    {
+        // Acks the transaction.
+        status = USB_TransactionCompleteAck(pipe);
+    }
+
+    if (status == SUCCESS)
+    {
+        // Handles control transactions separately.
+        if (pipe.address == 0U)
+        {
+            status = USB_ControlTransactionComplete(pipe);
+        }
+        else
+        {
+            // Regular handling of all regular endpoints.
+            status = USB_PipeTransactionComplete(pipe);
+        }
+    }
+
+    return status;
+}
+
 RETURN_CODE_t USB_TransferHandler(void)
 {
     RETURN_CODE_t status = UNINITIALIZED;
@@ -137,33 +169,16 @@ RETURN_CODE_t USB_TransferHandler(void)
     {
         status = USB_ControlSetupReceived();
     }
-    // If a transaction is complete, handle that one.
+    // If a transaction is complete, drain the FIFO up to the budget.
     else if (USB_TransactionIsCompleted() == true)
     {
-        // Finds out which pipe has a completed transaction.
-        USB_PIPE_t pipe;
-
-        status = USB_TransactionCompletedPipeGet(&pipe);
+        uint8_t budget = USB_TRANSFER_DRAIN_BUDGET;
 
-        if (status == SUCCESS)
-        {
-            // Acks the transaction.
-            status = USB_TransactionCompleteAck(pipe);
-        }
-
-        if (status == SUCCESS)
+        do
         {
-            // Handles control transactions separately.
-            if (pipe.address == 0U)
-            {
-                status = USB_ControlTransactionComplete(pipe);
-            }
-            else
-            {
-                // Regular handling of all regular endpoints.
-                status = USB_PipeTransactionComplete(pipe);
-            }
-        }
+            status = USB_TransactionCompletedHandle();
+            budget--;
+        } while ((status == SUCCESS) && (0u < budget) && (USB_TransactionIsCompleted() == true));
     }
     else
     {
@@ -105,7 +105,8 @@ RETURN_CODE_t USB_TransferAbort(USB_PIPE_t pipe);
  * @brief Handles the different types of packages received or transferred.
  *
  * Checks if a setup package is received or if a transaction is completed and which pipe has a completed transaction, then it handles them accordingly.
- * Sends an ACK upon completed transaction confirmation.
+ * Sends an ACK upon completed transaction confirmation. Completed transactions are drained from the FIFO
+ * until it is empty or USB_TRANSFER_DRAIN_BUDGET transactions have been handled.
  *
  * @param None.
  * @return SUCCESS or an Error code according to RETURN_CODE_t
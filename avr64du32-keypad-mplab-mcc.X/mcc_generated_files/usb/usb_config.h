@@ -47,6 +47,14 @@
  */
 #define USB_EP_NUM 2U 
 
+/**
+ * @ingroup usb_device_stack
+ * @def USB_TRANSFER_DRAIN_BUDGET
+ * @brief Maximum number of completed transactions handled by a single call to USB_TransferHandler.
+ * Set to 1 to handle one transaction per call.
+ */
+#define USB_TRANSFER_DRAIN_BUDGET (USB_EP_NUM * 2U)
+
 /**
  * @ingroup usb_device_stack
  * @def USB_EP0_SIZE
@@ -91,7 +99,28 @@
  * @def USB_HID_REPORT_DESCRIPTOR_SIZE
  * @brief Macro for the Human Interface Devices (HID) report descriptor size
  */
-#define USB_HID_REPORT_DESCRIPTOR_SIZE 59U
+#define USB_HID_REPORT_DESCRIPTOR_SIZE 84U
+
+/**
+ * @ingroup usb_device_stack
+ * @def USB_HID_KEYBOARD_REPORT_ID
+ * @brief Report ID of the keyboard input and output reports, sent as the first byte of each report.
+ */
+#define USB_HID_KEYBOARD_REPORT_ID 1U
+
+/**
+ * @ingroup usb_device_stack
+ * @def USB_HID_FEATURE_REPORT_ID
+ * @brief Report ID of the vendor feature report, sent as the first byte of each report.
+ */
+#define USB_HID_FEATURE_REPORT_ID 2U
+
+/**
+ * @ingroup usb_device_stack
+ * @def USB_HID_FEATURE_REPORT_SIZE
+ * @brief Size of the Human Interface Devices (HID) feature report, in bytes. Must match the report descriptor.
+ */
+#define USB_HID_FEATURE_REPORT_SIZE 32U
 
 /**
  * @ingroup usb_device_stack
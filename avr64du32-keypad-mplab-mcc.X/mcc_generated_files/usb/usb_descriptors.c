@@ -34,12 +34,14 @@
 #include "usb_descriptors.h"
 #include <usb_protocol_headers.h>
 
-//Report descriptor for a standard keyboard
+//Report descriptor for a standard keyboard, and a vendor collection for the keymap feature report
+//There are two top-level collections, so each report has an ID
 USB_HID_REPORT_DESCRIPTOR_t USB_HIDKeyboardReportDescriptor = {
     {
         0x05, 0x01, /* Usage Page (Generic Desktop)      */
         0x09, 0x06, /* Usage (Keyboard)                  */
         0xA1, 0x01, /* Collection (Application)          */
+        0x85, USB_HID_KEYBOARD_REPORT_ID, /* Report ID   */
         0x05, 0x07, /* Usage Page (Keyboard)             */
         0x19, 0xE0, /* Usage Minimum (224)               */
         0x29, 0xE7, /* Usage Maximum (231)               */
@@ -66,6 +68,17 @@ USB_HID_REPORT_DESCRIPTOR_t USB_HIDKeyboardReportDescriptor = {
         0x91, 0x02, /* Output (Data, Variable, Absolute) */
         0x95, 0x03, /* Report Count (3)                  */
         0x91, 0x01, /* Output (Constant)                 */
+        0xC0,       /* End Collection                    */
+        0x06, 0x00, 0xFF, /* Usage Page (Vendor Defined) */
+        0x09, 0x01, /* Usage (1)                         */
+        0xA1, 0x01, /* Collection (Application)          */
+        0x85, USB_HID_FEATURE_REPORT_ID, /* Report ID    */
+        0x09, 0x01, /* Usage (1)                         */
+        0x15, 0x00, /* Logical Minimum (0)               */
+        0x26, 0xFF, 0x00, /* Logical Maximum (255)       */
+        0x75, 0x08, /* Report Size (8)                   */
+        0x95, 0x20, /* Report Count (32)                 */
+        0xB1, 0x02, /* Feature (Data, Variable, Absolute)*/
         0xC0        /* End Collection                    */
     },
 };
@@ -59,6 +59,14 @@ RETURN_CODE_t USBDevice_Handle(void);
  * @return USB status code
  */ 
 RETURN_CODE_t USBDevice_StatusGet(void);
+
+/**
+ * @ingroup usb_device_stack
+ * @brief Clears a latched error so USBDevice_Handle resumes servicing the stack after a recovery.
+ * @param None.
+ * @return None.
+ */ 
+void USBDevice_StatusClear(void);
     
 /**
  * @ingroup usb_device_stack
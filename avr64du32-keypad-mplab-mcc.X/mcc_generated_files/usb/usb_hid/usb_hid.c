@@ -46,6 +46,11 @@ STATIC uint16_t descriptorLength = 0;
 STATIC USB_DESCRIPTOR_TYPE_HID_t descriptorType;
 STATIC USB_HID_REPORT_CALLBACK_t reportCallback = NULL;
 
+STATIC uint8_t featureReport[USB_HID_FEATURE_REPORT_SIZE + 1U];
+STATIC uint16_t featureReportLength = 0;
+STATIC USB_HID_FEATURE_GET_CALLBACK_t featureGetCallback = NULL;
+STATIC USB_HID_FEATURE_SET_CALLBACK_t featureSetCallback = NULL;
+
 void USB_HIDReportUpdatedCallbackRegister(USB_HID_REPORT_CALLBACK_t callback)
 {
     reportCallback = callback;
@@ -53,9 +58,26 @@ void USB_HIDReportUpdatedCallbackRegister(USB_HID_REPORT_CALLBACK_t callback)
 
 void USB_HIDReportUpdatedCallback(void)
 {
-    if (reportCallback != NULL)
+    // The first byte is the report ID, and only the keyboard has an output report.
+    if ((reportCallback != NULL) && (USB_HID_KEYBOARD_REPORT_ID == (uint8_t)reportData))
+    {
+        reportCallback(reportData >> 8);
+    }
+    USB_ControlEndOfRequestCallbackRegister(NULL);
+}
+
+void USB_HIDFeatureReportCallbackRegister(USB_HID_FEATURE_GET_CALLBACK_t getCallback, USB_HID_FEATURE_SET_CALLBACK_t setCallback)
+{
+    featureGetCallback = getCallback;
+    featureSetCallback = setCallback;
+}
+
+void USB_HIDFeatureReportUpdatedCallback(void)
+{
+    if (featureSetCallback != NULL)
     {
-        reportCallback(reportData);
+        // The first byte is the report ID.
+        featureSetCallback(&featureReport[1], featureReportLength - 1U);
     }
     USB_ControlEndOfRequestCallbackRegister(NULL);
 }
@@ -111,7 +133,8 @@ RETURN_CODE_t USB_HIDRequestHandler(USB_SETUP_REQUEST_t *setupRequestPtr)
         }
         if (USB_REQUEST_TYPE_CLASS == (USB_REQUEST_TYPE_t)setupRequestPtr->bmRequestType.type)
         {
-            uint8_t reportType = (setupRequestPtr->wValue >> 8) - 1;
+            uint8_t reportType = setupRequestPtr->wValue >> 8;
+            uint8_t reportId = setupRequestPtr->wValue & 0xFF;
             // Requests Class Interface Get
             switch (setupRequestPtr->bRequest)
             {
@@ -121,6 +144,18 @@ RETURN_CODE_t USB_HIDRequestHandler(USB_SETUP_REQUEST_t *setupRequestPtr)
                     // Answers with a stall condition on control endpoint as input reports are transferred on interrupt endpoint.
                     status = UNSUPPORTED;
                 }
+                else if ((USB_HID_REPORT_TYPE_FEATURE == (USB_HID_REPORT_TYPE_t)reportType) && (USB_HID_FEATURE_REPORT_ID == reportId)
+                        && (featureGetCallback != NULL))
+                {
+                    // The report ID is sent first.
+                    featureReport[0] = USB_HID_FEATURE_REPORT_ID;
+                    featureReportLength = featureGetCallback(&featureReport[1], USB_HID_FEATURE_REPORT_SIZE) + 1U;
+                    if (featureReportLength > setupRequestPtr->wLength)
+                    {
+                        featureReportLength = setupRequestPtr->wLength;
+                    }
+                    status = USB_TransferControlDataSet(featureReport, featureReportLength, NULL);
+                }
                 else
                 {
                     status = UNSUPPORTED;
@@ -163,6 +198,33 @@ RETURN_CODE_t USB_HIDRequestHandler(USB_SETUP_REQUEST_t *setupRequestPtr)
             switch (setupRequestPtr->bRequest)
             {
             case USB_REQ_HID_SET_REPORT:
+                if (USB_HID_REPORT_TYPE_FEATURE == (USB_HID_REPORT_TYPE_t)(setupRequestPtr->wValue >> 8))
+                {
+                    // Feature reports are received into their own buffer, after the report ID.
+                    if ((featureSetCallback == NULL) || (USB_HID_FEATURE_REPORT_ID != (setupRequestPtr->wValue & 0xFF))
+                            || (setupRequestPtr->wLength == 0U) || (setupRequestPtr->wLength > (USB_HID_FEATURE_REPORT_SIZE + 1U)))
+                    {
+                        status = UNSUPPORTED;
+                        break;
+                    }
+                    featureReportLength = setupRequestPtr->wLength;
+                    status = USB_TransferControlDataSet(featureReport, featureReportLength, NULL);
+                    if (SUCCESS == status)
+                    {
+                        USB_ControlEndOfRequestCallbackRegister(USB_HIDFeatureReportUpdatedCallback);
+                    }
+                    else
+                    {
+                        status = UNSUPPORTED;
+                    }
+                    break;
+                }
+                if ((USB_HID_KEYBOARD_REPORT_ID != (setupRequestPtr->wValue & 0xFF)) || (setupRequestPtr->wLength > sizeof(reportData)))
+                {
+                    // Output report is not the keyboard report, or does not fit in the buffer.
+                    status = UNSUPPORTED;
+                    break;
+                }
                 status = USB_TransferControlDataSet((uint8_t *)&reportData, setupRequestPtr->wLength, NULL);
                 if (SUCCESS == status)
                 {
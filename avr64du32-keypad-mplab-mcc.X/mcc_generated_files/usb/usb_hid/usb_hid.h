@@ -53,6 +53,23 @@ void USB_HIDReportUpdatedCallbackRegister(USB_HID_REPORT_CALLBACK_t callback);
  */
 void USB_HIDReportUpdatedCallback(void);
 
+/**
+ * @ingroup usb_hid
+ * @brief Registers the callbacks for the HID feature report. Feature requests are stalled while no callback is registered.
+ * @param getCallback - Callback that fills in the report for GET_REPORT
+ * @param setCallback - Callback that receives the report from SET_REPORT
+ * @return None.
+ */
+void USB_HIDFeatureReportCallbackRegister(USB_HID_FEATURE_GET_CALLBACK_t getCallback, USB_HID_FEATURE_SET_CALLBACK_t setCallback);
+
+/**
+ * @ingroup usb_hid
+ * @brief Passes a received feature report to the callback and calls the End Of Request function.
+ * @param None.
+ * @return None.
+ */
+void USB_HIDFeatureReportUpdatedCallback(void);
+
 /**
  * @ingroup usb_hid
  * @brief Registers the rate, protocol and report descriptor for HID.
@@ -43,7 +43,8 @@
 
 STATIC USB_PIPE_t keyboardPipe = {.address = USB_HID_INTERRUPT_EP, .direction = USB_EP_DIR_IN};
 STATIC USB_KEYBOARD_REPORT_DATA_t *nextKeyboardReport = NULL;
-STATIC USB_KEYBOARD_REPORT_DATA_t keyboardReportBuffer;
+STATIC uint8_t keyboardReportBuffer[sizeof(USB_KEYBOARD_REPORT_DATA_t) + 1U];
+STATIC USB_EVENT_CALLBACK_t keyboardReportSentCallback = NULL;
 
 STATIC USB_PIPE_t mousePipe = {.address = USB_HID_INTERRUPT_EP, .direction = USB_EP_DIR_IN};
 STATIC USB_MOUSE_REPORT_DATA_t mouseReportBuffer;
@@ -59,8 +60,10 @@ RETURN_CODE_t USB_HIDKeyboardReportInSend(USB_KEYBOARD_REPORT_DATA_t *data)
     }
     else
     {
-        (void)memcpy(&keyboardReportBuffer, data, sizeof(USB_KEYBOARD_REPORT_DATA_t));
-        status = USB_TransferWriteStart(keyboardPipe, (uint8_t *)&keyboardReportBuffer, sizeof(USB_KEYBOARD_REPORT_DATA_t), false, USB_HIDKeyboardInputReportSentCallback);
+        // The report ID is sent first.
+        keyboardReportBuffer[0] = USB_HID_KEYBOARD_REPORT_ID;
+        (void)memcpy(&keyboardReportBuffer[1], data, sizeof(USB_KEYBOARD_REPORT_DATA_t));
+        status = USB_TransferWriteStart(keyboardPipe, keyboardReportBuffer, sizeof(keyboardReportBuffer), false, USB_HIDKeyboardInputReportSentCallback);
     }
     return status;
 }
@@ -71,6 +74,11 @@ void USB_HIDKeyboardInputReportSentCallback(USB_PIPE_t pipe, USB_TRANSFER_STATUS
     (void)(status);
     (void)(bytesTransferred);
 
+    if (keyboardReportSentCallback != NULL)
+    {
+        keyboardReportSentCallback();
+    }
+
     if (nextKeyboardReport != NULL)
     {
         USB_HIDKeyboardReportInSend(nextKeyboardReport);
@@ -78,6 +86,16 @@ void USB_HIDKeyboardInputReportSentCallback(USB_PIPE_t pipe, USB_TRANSFER_STATUS
     }
 }
 
+void USB_HIDKeyboardReportSentCallbackRegister(USB_EVENT_CALLBACK_t callback)
+{
+    keyboardReportSentCallback = callback;
+}
+
+bool USB_HIDKeyboardReportInIsBusy(void)
+{
+    return (USB_PipeStatusIsBusy(keyboardPipe) || (nextKeyboardReport != NULL));
+}
+
 RETURN_CODE_t USB_HIDMouseReportInSend(USB_MOUSE_REPORT_DATA_t *data)
 {
     RETURN_CODE_t status = UNINITIALIZED;
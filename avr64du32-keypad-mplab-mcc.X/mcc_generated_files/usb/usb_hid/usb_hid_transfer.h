@@ -64,6 +64,23 @@ void USB_HIDKeyboardInputReportSentCallback(USB_PIPE_t pipe, USB_TRANSFER_STATUS
  */
 RETURN_CODE_t USB_HIDMouseReportInSend(USB_MOUSE_REPORT_DATA_t *data);
 
+/**
+ * @ingroup usb_hid_transfer
+ * @brief Registers a callback called each time a keyboard input report has been sent to the host.
+ * @param callback - Reference for the callback function
+ * @return None.
+ */
+void USB_HIDKeyboardReportSentCallbackRegister(USB_EVENT_CALLBACK_t callback);
+
+/**
+ * @ingroup usb_hid_transfer
+ * @brief Checks if a keyboard input report is still being sent.
+ * @param None.
+ * @retval true - A report is in progress, USB_HIDKeyboardReportInSend() will defer the next report
+ * @retval false - The next report is copied and sent at once
+ */
+bool USB_HIDKeyboardReportInIsBusy(void);
+
 /**
  * @}
  */
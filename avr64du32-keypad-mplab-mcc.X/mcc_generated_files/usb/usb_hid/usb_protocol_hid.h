@@ -176,6 +176,18 @@ typedef struct
  */
 typedef void (*USB_HID_REPORT_CALLBACK_t)(uint16_t report);
 
+/**
+ * @ingroup usb_hid
+ * @brief Defines a type for a callback that fills in a feature report for GET_REPORT and returns its length.
+ */
+typedef uint16_t (*USB_HID_FEATURE_GET_CALLBACK_t)(uint8_t *data, uint16_t maxLength);
+
+/**
+ * @ingroup usb_hid
+ * @brief Defines a type for a callback that receives a feature report from SET_REPORT.
+ */
+typedef void (*USB_HID_FEATURE_SET_CALLBACK_t)(uint8_t *data, uint16_t length);
+
 /**
  * @ingroup usb_hid
  * @name USB descriptor codes
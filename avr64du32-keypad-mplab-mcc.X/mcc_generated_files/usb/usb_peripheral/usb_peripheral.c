@@ -40,6 +40,13 @@ SOFTWARE.
 #include <usb_peripheral_avr_du.h>
 #include <usb_protocol_headers.h>
 
+// The bus event masks mirror the INTFLAGSA layout so snapshots need no translation.
+#if (USB_EVENT_SOF != USB_SOF_bm) || (USB_EVENT_SUSPEND != USB_SUSPEND_bm) || (USB_EVENT_RESUME != USB_RESUME_bm) \
+    || (USB_EVENT_RESET != USB_RESET_bm) || (USB_EVENT_STALLED != USB_STALLED_bm) || (USB_EVENT_UNDERFLOW != USB_UNF_bm) \
+    || (USB_EVENT_OVERFLOW != USB_OVF_bm)
+#error "USB_EVENT_* masks do not match the INTFLAGSA register layout"
+#endif
+
 STATIC USB_CONTROL_TRANSFER_t controlTransfer __attribute__((aligned(2))) = { .transferDataPtr = controlTransfer.buffer };
 
 bool USB_SetupIsReceived(void)
@@ -47,6 +54,16 @@ bool USB_SetupIsReceived(void)
     return USB_SetupInterruptIs();
 }
 
+uint8_t USB_EventsReceivedGet(void)
+{
+    return USB_BusEventInterruptFlagsGet();
+}
+
+void USB_EventsClear(uint8_t events)
+{
+    USB_BusEventInterruptFlagsClear(events);
+}
+
 bool USB_EventSOFIsReceived(void)
 {
     return USB_SOFInterruptIs();
@@ -41,6 +41,21 @@
 #include <usb_peripheral_read_write.h>
 #include <usb_protocol_headers.h>
 
+/**
+ * @ingroup usb_peripheral
+ * @name USB Bus Event Masks
+ * Bitmasks of the bus events returned by USB_EventsReceivedGet.
+ */
+///@{
+#define USB_EVENT_SOF 0x80u
+#define USB_EVENT_SUSPEND 0x40u
+#define USB_EVENT_RESUME 0x20u
+#define USB_EVENT_RESET 0x10u
+#define USB_EVENT_STALLED 0x08u
+#define USB_EVENT_UNDERFLOW 0x04u
+#define USB_EVENT_OVERFLOW 0x02u
+///@}
+
 /**
  * @ingroup usb_peripheral
  * @struct USB_CONTROL_TRANSFER_t
@@ -68,6 +83,22 @@ typedef struct USB_CONTROL_TRANSFER_struct
  */
 bool USB_SetupIsReceived(void);
 
+/**
+ * @ingroup usb_peripheral
+ * @brief Reads a snapshot of all pending bus events.
+ * @param None.
+ * @return A bitmask of USB_EVENT_* values representing the events received
+ */
+uint8_t USB_EventsReceivedGet(void);
+
+/**
+ * @ingroup usb_peripheral
+ * @brief Clears the selected bus events.
+ * @param events - Bitmask of USB_EVENT_* values to clear
+ * @return None.
+ */
+void USB_EventsClear(uint8_t events);
+
 /**
  * @ingroup usb_peripheral
  * @brief Detects if the Start-of-Frame (SOF) event was received.
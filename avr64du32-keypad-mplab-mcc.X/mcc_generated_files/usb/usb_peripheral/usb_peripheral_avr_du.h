@@ -1915,6 +1915,28 @@ static ALWAYS_INLINE bool USB_SetupInterruptIs(void)
     return ((USB0.INTFLAGSB & USB_SETUP_bm) != 0u);
 }
 
+/**
+ * @ingroup usb_peripheral_avr_du
+ * @brief Reads all the USB bus event interrupt flags in a single access.
+ * @param None.
+ * @return The content of the INTFLAGSA register
+ */
+static ALWAYS_INLINE uint8_t USB_BusEventInterruptFlagsGet(void)
+{
+    return USB0.INTFLAGSA;
+}
+
+/**
+ * @ingroup usb_peripheral_avr_du
+ * @brief Clears the selected USB bus event interrupt flags in a single access.
+ * @param flags - Bitmask of the INTFLAGSA flags to clear
+ * @return None.
+ */
+static ALWAYS_INLINE void USB_BusEventInterruptFlagsClear(uint8_t flags)
+{
+    USB0.INTFLAGSA = flags;
+}
+
 /**
  * @ingroup usb_peripheral_avr_du
  * @brief Clears all the USB Interrupt flags.
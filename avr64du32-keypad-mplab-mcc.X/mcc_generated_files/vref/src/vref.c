@@ -37,6 +37,9 @@ int8_t VREF_Initialize(void)
     // ALWAYSON disabled; REFSEL Internal 2.048V reference; 
     VREF.ACREF = 0x1;
     
+    // ALWAYSON disabled; REFSEL VDD; 
+    VREF.ADC0REF = 0x5;
+    
     
     
 	return 0;